@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <ctype.h>
+#include <strings.h>
 #include "pico/stdlib.h"
 #include "pico/cyw43_arch.h"
 #include "pico/bootrom.h"
@@ -12,12 +13,29 @@
 #include "hardware/adc.h"
 #include "hardware/gpio.h"
 #include "hardware/pwm.h"
+#include "hardware/dma.h"
+#include "hardware/structs/systick.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "pico/multicore.h"
 #include "ws2818b.pio.h"
 #include "lwip/tcp.h"
 #include "lib/aht20.h"
 #include "lib/bmp280.h"
 #include "lib/ssd1306.h"
+#include "lib/json_writer.h"
+#include "lib/measurement.h"
+#include "lib/derived.h"
+#include "lib/pipeline.h"
+#include "lib/http_parser.h"
+#include "lib/sample_store.h"
+#include "lib/flash_log.h"
+#include "lib/spsc_ring.h"
+#include "lib/snapshot.h"
+#include "lib/scheduler.h"
+#include "lib/sequencer.h"
 #include "lib/font.h"
+#include "web_assets.h"
 
 // ==================== CONFIGURAÇÕES E DEFINIÇÕES ====================
 
@@ -37,6 +55,9 @@
 #define DISPLAY_ADDR 0x3C
 // Foi necessário alterar o endereço do bmp280.c para 0x77
 
+// Modo/oversampling do BMP280: medição forçada disparada junto com o AHT20
+#define BMP280_PRESET bmp280_preset_weather
+
 // GPIOs
 #define BOTAO_A 5
 #define BOTAO_B 6
@@ -45,67 +66,253 @@
 #define RED_PIN    13
 #define BLUE_PIN   12
 #define GREEN_PIN  11
+#define BUZZER_TONE_HZ 2000
+#define LED_ON 255                        // Brilho PWM do LED RGB
 
 // Constantes
-#define SEA_LEVEL_PRESSURE 101325.0
 #define UPDATE_INTERVAL_MS 1000
+#define SAMPLE_FILTER_SHIFT 2             // Média exponencial com peso 1/4; 0 tira o estágio de filtro
+#define CALIBRATION_GAIN_ONE 10000        // Ganhos com 4 casas: 10000 = 1,0000
+#define CALIBRATION_GAIN_DECIMALS 4
 #define MAX_DATA_POINTS 50
+#define HISTORY_1M_POINTS 120             // 2 h em buckets de 1 minuto
+#define HISTORY_1H_POINTS 168             // 7 dias em buckets de 1 hora
+#define HISTORY_METRICS 3                 // Temperatura, umidade, pressão
+#define HISTORY_RAW_BLOCKS 4              // Blocos comprimidos de 1 s (~200 amostras cada num dia calmo)
+#define HISTORY_LOG_SECTORS 64            // 256 KB no fim da flash: ~5 dias de buckets de 1 min
+#define HISTORY_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - HISTORY_LOG_SECTORS * FLASH_SECTOR_SIZE)
 #define DEBOUNCE_DELAY_MS 200
 #define SQUARE_SIZE 8
 #define LED_COUNT 25
+#define NP_GAMMA 2.2f                     // Níveis da matriz são perceptuais
+#define NP_BRIGHTNESS 255                 // Brilho máximo da matriz (0-255)
+#define NP_LATCH_US 300                   // Linha em 0 que fecha o quadro (WS2812B: >280 us)
+#define NP_FRAME_US (LED_COUNT * 24 * 5 / 4)  // 1,25 us por bit
+#define DISPLAY_PAGES 5
+#define DISPLAY_RETRY_MS 5                // Nova tentativa com o DMA do display ocupado
+#define HTTP_RESPONSE_SIZE 3072           // Maior corpo JSON (histórico completo)
+#define HTTP_HEADER_SIZE 256              // Cabeçalho (ou uma resposta pequena inteira)
+#define HTTP_MAX_CONNECTIONS 8            // Slots fixos de conexão; acima disso, 503
+#define HTTP_BODY_CACHE_SLOTS 4           // Corpos JSON compartilhados entre conexões
+#define HTTP_MAX_REQUESTS_PER_CONN 100
+#define HTTP_IDLE_TIMEOUT_S 5
+#define HTTP_POLL_INTERVAL 2              // tcp_poll em unidades de 500 ms
+#define HTTP_MAX_SSE_CLIENTS 4
+#define HTTP_SSE_MAX_INFLIGHT 512         // Bytes de eventos ainda sem ACK por cliente
+#define SAMPLE_RING_SIZE 8                // Amostras do núcleo 1 ainda não consumidas pelo 0
+#define FLASH_SERVICE_INTERVAL_MS 100     // Gravações/apagamentos adiados do log
+#define BOOTSEL_DELAY_MS 500              // LED amarelo visível antes do reset
 
 // ==================== ESTRUTURAS DE DADOS ====================
 
+// Limites, offsets e QNH nas unidades de measurement_t (centésimos de °C e %UR,
+// Pa); ganhos em unidades de 1/CALIBRATION_GAIN_ONE
 typedef struct {
-    float temp_min;
-    float temp_max;
-    float humid_min;
-    float humid_max;
-    float press_min;
-    float press_max;
-    float temp_offset;
-    float humid_offset;
-    float press_offset;
+    int32_t temp_min;
+    int32_t temp_max;
+    int32_t humid_min;
+    int32_t humid_max;
+    int32_t press_min;
+    int32_t press_max;
+    int32_t temp_offset;
+    int32_t humid_offset;
+    int32_t press_offset;
+    int32_t temp_gain;
+    int32_t humid_gain;
+    int32_t press_gain;
+    int32_t qnh;                         // Pressão ao nível do mar para a altitude
+    int32_t heat_max;                    // Limite do índice de calor
 } Config;
 
+// Amostra que saiu do pipeline do núcleo 1, enviada ao núcleo 0
+typedef struct {
+    measurement_t value;
+    bool alarm;
+} SensorSample;
+
 typedef struct {
-    float temperature[MAX_DATA_POINTS];
-    float humidity[MAX_DATA_POINTS];
-    float pressure[MAX_DATA_POINTS];
+    int32_t temperature[MAX_DATA_POINTS];  // Unidades de measurement_t
+    int32_t humidity[MAX_DATA_POINTS];
+    int32_t pressure[MAX_DATA_POINTS];
+    uint32_t seq[MAX_DATA_POINTS];       // Número de sequência da amostra (começa em 1)
+    uint32_t time_s[MAX_DATA_POINTS];    // Instante da amostra, no relógio do histórico
+    uint32_t next_seq;                   // Sequência que a próxima amostra recebe
     int index;
     int count;
 } HistoricalData;
 
+// Resumo de um intervalo fechado, em ponto fixo: temperatura e umidade em
+// centésimos (°C, %), pressão em décimos de hPa
+typedef struct {
+    uint32_t time_s;                     // Início do intervalo, no relógio do histórico
+    int16_t min[HISTORY_METRICS];
+    int16_t max[HISTORY_METRICS];
+    int16_t mean[HISTORY_METRICS];
+} HistoryBucket;
+
+// Camada de histórico agregado: anel de buckets + acumulador do bucket aberto
+typedef struct {
+    HistoryBucket *buckets;
+    uint16_t size;
+    uint32_t period_s;
+    uint32_t total;                      // Buckets fechados desde o boot (id do próximo)
+    uint32_t start_s;                    // Início do bucket aberto
+    uint16_t samples;                    // Amostras no bucket aberto
+    int32_t sum[HISTORY_METRICS];
+    int16_t min[HISTORY_METRICS];
+    int16_t max[HISTORY_METRICS];
+} HistoryTier;
+
+// Bucket de 1 minuto como gravado no log da flash (payload de um registro)
+typedef struct {
+    uint32_t time_s;                     // Início do intervalo, no relógio do histórico
+    uint16_t boot;                       // Boot em que foi gravado
+    int16_t min[HISTORY_METRICS];
+    int16_t max[HISTORY_METRICS];
+    int16_t mean[HISTORY_METRICS];
+} HistoryLogEntry;
+_Static_assert(sizeof(HistoryLogEntry) == FLASH_LOG_PAYLOAD, "HistoryLogEntry deve ocupar um registro");
+
 struct pixel_t {
     uint8_t G, R, B;
 };
 typedef struct pixel_t pixel_t;
 typedef pixel_t npLED_t;
 
-struct http_state {
-    char response[8192];
+// Trecho de resposta enviado por referência, sem TCP_WRITE_FLAG_COPY
+typedef struct {
+    const char *data;
     size_t len;
-    size_t sent;
+} http_chunk_t;
+
+// Corpos JSON que o cache compartilha
+typedef enum {
+    HTTP_BODY_DATA_FULL,     // /api/data (histórico inteiro)
+    HTTP_BODY_DATA_DELTA,    // /api/data?since=<seq anterior> (só a última amostra)
+    HTTP_BODY_CONFIG,        // /api/config
+    HTTP_BODY_DATA_SINCE     // /api/data?since=<seq mais antiga>: gerado por conexão, fora do cache
+} http_body_kind_t;
+
+// Corpo serializado uma vez por versão e enviado por referência a todas as conexões.
+// Fica preso enquanto alguma conexão ainda não recebeu o ACK dele.
+typedef struct {
+    char data[HTTP_RESPONSE_SIZE];
+    size_t len;              // 0: slot vazio
+    http_body_kind_t kind;
+    uint32_t seq;            // Amostra mais nova quando foi gerado (0 para config)
+    uint32_t config_version;
+    uint8_t refs;
+} http_body_t;
+
+struct http_state;
+
+// Gera o próximo trecho de uma resposta longa em buf e retorna o tamanho;
+// marca stream.done no último trecho
+typedef size_t (*http_producer_fn)(struct http_state *hs, char *buf, size_t cap);
+
+// Resposta gerada aos poucos, reaproveitando um buffer a cada ACK completo
+typedef struct {
+    http_producer_fn producer;   // NULL: resposta comum
+    json_writer_t json;          // Estado do JSON entre um trecho e outro
+    uint32_t first;              // Primeiro item (id absoluto), fixado no início
+    uint32_t count;
+    uint32_t pos;                // Próximo item do campo atual
+    uint8_t source;              // Série escolhida (depende do producer)
+    uint8_t field;               // Campo (array) atual
+    sample_cursor_t cursor;      // Leitura do histórico comprimido
+    flash_log_iter_t log;        // Leitura do log na flash
+    bool started;
+    bool opened;                 // O array do campo atual já foi aberto
+    bool chunked;                // Transfer-Encoding: chunked (HTTP/1.1)
+    bool done;
+} http_stream_t;
+
+// Estado de uma conexão; persiste entre requisições (keep-alive)
+struct http_state {
+    struct tcp_pcb *pcb;         // NULL: slot livre
+    struct pbuf *rx;             // Bytes recebidos ainda não processados (pipeline)
+    http_parser_t parser;        // Requisição em andamento
+    http_chunk_t chunks[3];      // Cabeçalho + Connection + corpo (flash) ou cabeçalho + corpo JSON
+    uint8_t chunk_count;
+    uint8_t chunk;               // Próximo trecho a enfileirar
+    size_t offset;               // Posição dentro do trecho atual
+    size_t len;                  // Tamanho total da resposta
+    size_t sent;                 // Bytes já confirmados pelo cliente
+    char header[HTTP_HEADER_SIZE]; // Cabeçalho das respostas da API
+    struct http_state *next_free; // Encadeamento da lista de slots livres
+    http_body_t *body;           // Corpo do cache em envio (referência contada)
+    char *response;              // Corpo fora do cache (since antigo) ou buffer do stream
+    http_stream_t stream;
+    uint16_t requests;           // Requisições atendidas nesta conexão
+    uint8_t idle_ticks;          // Chamadas de http_poll sem atividade
+    bool busy;                   // Resposta em andamento
+    bool close_after;            // Fecha a conexão ao concluir a resposta atual
+    bool peer_closed;            // Cliente já encerrou o envio
+    bool sse;                    // Conexão presa ao fluxo /api/stream
+    bool sse_pending;            // Há amostra mais nova que não coube no envio
 };
 
 // ==================== VARIÁVEIS GLOBAIS ====================
+//
+// Divisão entre os núcleos, depois de multicore_launch_core1():
+// - Núcleo 0 (rede): cyw43/lwIP e servidor HTTP, config, config_version,
+//   reading, history e camadas, history_store e history_log. Os callbacks do
+//   lwIP também rodam no núcleo 0; o laço principal trava a pilha
+//   (cyw43_arch_lwip_begin) quando altera o que eles leem.
+// - Núcleo 1 (sensores): I2C dos sensores e do display, ssd, sensor_data,
+//   bmp_pressure, measured, sample_pipeline, alarm_active, sensor_config,
+//   current_page, digit, matriz de LEDs, seq (LED RGB e buzzer) e botões.
+// - Entre os dois: sample_ring (1 -> 0, cada amostra) e config_snapshot
+//   (0 -> 1, só a mais recente), mais net_ip (só o 0 escreve, uma palavra).
+//   Cada núcleo roda seu escalonador (net_sched, ui_sched); o outro só
+//   dispara tarefas nele (sched_trigger) e lê as estatísticas.
+// Antes do lançamento o núcleo 0 usa o display para as mensagens do WiFi.
 
 Config config = {
-    .temp_min = 10.0, .temp_max = 35.0,
-    .humid_min = 20.0, .humid_max = 80.0,
-    .press_min = 900.0, .press_max = 1100.0,
-    .temp_offset = 0.0, .humid_offset = 0.0, .press_offset = 0.0
+    .temp_min = 1000, .temp_max = 3500,        // 10,00 a 35,00 °C
+    .humid_min = 2000, .humid_max = 8000,      // 20,00 a 80,00 %
+    .press_min = 90000, .press_max = 110000,   // 900,00 a 1100,00 hPa
+    .temp_offset = 0, .humid_offset = 0, .press_offset = 0,
+    .temp_gain = CALIBRATION_GAIN_ONE, .humid_gain = CALIBRATION_GAIN_ONE, .press_gain = CALIBRATION_GAIN_ONE,
+    .qnh = DERIVED_QNH_DEFAULT,
+    .heat_max = 4000                           // 40,00 °C
 };
 
-HistoricalData history = {0};
+Config sensor_config;          // Cópia aplicada pelo núcleo 1 (lida do config_snapshot)
+SensorSample reading;          // Última amostra recebida do núcleo 1
+
+SensorSample sample_ring_items[SAMPLE_RING_SIZE];
+spsc_ring_t sample_ring = SPSC_RING_INIT(sample_ring_items);
+Config config_snapshot_copies[2];
+snapshot_t config_snapshot = SNAPSHOT_INIT(config_snapshot_copies);
+volatile uint32_t net_ip = 0;              // Endereço IPv4 com o link ativo; 0 sem conexão
+
+HistoricalData history = { .next_seq = 1 };
+uint32_t config_version = 1;   // Incrementada a cada POST /api/config
+HistoryBucket history_1m[HISTORY_1M_POINTS];
+HistoryBucket history_1h[HISTORY_1H_POINTS];
+HistoryTier history_tiers[] = {
+    { .buckets = history_1m, .size = HISTORY_1M_POINTS, .period_s = 60 },
+    { .buckets = history_1h, .size = HISTORY_1H_POINTS, .period_s = 60 * 60 },
+};
+#define HISTORY_TIER_COUNT (sizeof(history_tiers) / sizeof(history_tiers[0]))
+sample_block_t history_blocks[HISTORY_RAW_BLOCKS];
+sample_store_t history_store = { .blocks = history_blocks, .block_count = HISTORY_RAW_BLOCKS };
+flash_log_t history_log;
+bool history_log_ready = false;
+uint16_t history_boot = 0;
+uint32_t history_epoch_s = 0;   // Relógio do histórico no boot: continua o do log
+
+// Núcleo 1: leituras cruas e estado da interface local
 AHT20_Data sensor_data;
-float bmp_temperature = 0;
-float bmp_pressure = 0;
-float altitude = 0;
+struct bmp280_calib_param bmp_params;
+int32_t bmp_pressure = 0;              // Pa
+measurement_t measured;                // Última amostra que passou pelo pipeline inteiro
 int current_page = 0;
 bool alarm_active = false;
 ssd1306_t ssd;
 int digit = 2;
+sequencer_t seq;
 
 // Variáveis para controle dos botões
 volatile bool button_a_pressed = false;
@@ -116,6 +323,15 @@ volatile uint32_t last_button_time = 0;
 npLED_t leds[LED_COUNT];
 PIO np_pio;
 uint sm;
+uint np_dma;
+uint8_t np_gamma[256];                 // Nível perceptual -> PWM do LED, já com o brilho
+uint32_t np_frame[LED_COUNT];          // Próximo quadro, GRB << 8 (formato do PIO)
+uint32_t np_sent[LED_COUNT];           // Quadro no DMA / último enviado
+uint64_t np_ready_at = 0;              // Fim do latch do último quadro
+volatile bool np_pending = false;      // Alarme armado para enviar np_frame (limpo na IRQ)
+uint32_t np_frames = 0;
+uint32_t np_skipped = 0;               // Quadros iguais ao anterior
+alarm_pool_t *ui_pool;                 // Alarmes do núcleo 1 (escalonador, sequenciador, matriz)
 
 // ==================== PROTÓTIPOS DE FUNÇÕES ====================
 
@@ -135,14 +351,29 @@ void npDisplayDigit(int digit);
 void npClear(void);
 void npInit(uint pin);
 
-// Funções de controle de hardware
-void set_rgb_led(uint8_t r, uint8_t g, uint8_t b);
-void buzzer_beep(int duration_ms);
-
 // Funções de processamento de dados
-float calculate_altitude(float pressure);
-void add_to_history(float temp, float humid, float press);
-void check_alarms(void);
+void history_restore(void);
+void add_to_history(const measurement_t *m);
+
+// Estágios do processamento de cada amostra (núcleo 1)
+bool sample_capture(measurement_t *m);
+bool sample_calibrate(measurement_t *m);
+bool sample_filter(measurement_t *m);
+bool sample_derive(measurement_t *m);
+bool check_alarms(measurement_t *m);
+bool sample_publish(measurement_t *m);
+
+// Núcleos e tarefas dos escalonadores
+void core1_main(void);
+void core0_receive_samples(void);
+void network_task(void);
+void flash_task(void);
+void reboot_task(void);
+void config_task(void);
+void sensors_task(void);
+void display_task(void);
+void matrix_task(void);
+void bootsel_task(void);
 
 // Funções de interface
 void update_display(void);
@@ -151,29 +382,85 @@ void gpio_callback(uint gpio, uint32_t events);
 
 // Funções do servidor HTTP
 void start_http_server(void);
+bool http_idle(void);
+void http_sse_publish(void);
 static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err);
 static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
 static err_t http_sent(void *arg, struct tcp_pcb *tpcb, u16_t len);
+static err_t http_poll(void *arg, struct tcp_pcb *tpcb);
+static void http_err(void *arg, err_t err);
+static void http_send_more(struct tcp_pcb *tpcb, struct http_state *hs);
+
+// ==================== TAREFAS ====================
+
+// Núcleo 0. As requisições HTTP não são tarefas: o lwIP as atende na IRQ do cyw43.
+enum { NET_TASK_SAMPLES, NET_TASK_NETWORK, NET_TASK_FLASH, NET_TASK_REBOOT };
+sched_task_t net_tasks[] = {
+    [NET_TASK_SAMPLES] = { .name = "samples", .fn = core0_receive_samples },  // Disparada pelo núcleo 1
+    [NET_TASK_NETWORK] = { .name = "network", .fn = network_task, .period_us = UPDATE_INTERVAL_MS * 1000 },
+    [NET_TASK_FLASH]   = { .name = "flash", .fn = flash_task, .period_us = FLASH_SERVICE_INTERVAL_MS * 1000 },
+    [NET_TASK_REBOOT]  = { .name = "reboot", .fn = reboot_task },
+};
+sched_t net_sched = SCHED_INIT(net_tasks);
+
+// Núcleo 1. Botões e config chegam por disparo (IRQ do GPIO, POST no núcleo 0);
+// display e matriz são redesenhados quando há leitura nova ou troca de página.
+enum { UI_TASK_BUTTONS, UI_TASK_CONFIG, UI_TASK_SENSORS, UI_TASK_DISPLAY, UI_TASK_MATRIX, UI_TASK_BOOTSEL };
+sched_task_t ui_tasks[] = {
+    [UI_TASK_BUTTONS] = { .name = "buttons", .fn = handle_buttons },
+    [UI_TASK_CONFIG]  = { .name = "config", .fn = config_task },
+    [UI_TASK_SENSORS] = { .name = "sensors", .fn = sensors_task, .period_us = UPDATE_INTERVAL_MS * 1000 },
+    [UI_TASK_DISPLAY] = { .name = "display", .fn = display_task },
+    [UI_TASK_MATRIX]  = { .name = "matrix", .fn = matrix_task },
+    [UI_TASK_BOOTSEL] = { .name = "bootsel", .fn = bootsel_task },
+};
+sched_t ui_sched = SCHED_INIT(ui_tasks);
+
+// Estágios de cada amostra, rodados pela tarefa de sensores sobre um único
+// registro. Display, alarmes, histórico e API só leem o resultado.
+pipeline_stage_t sample_stages[] = {
+    { .name = "capture", .fn = sample_capture },      // Sensores -> unidades de measurement_t
+    { .name = "calibrate", .fn = sample_calibrate },  // Ganho e offset da config
+#if SAMPLE_FILTER_SHIFT
+    { .name = "filter", .fn = sample_filter },
+#endif
+    { .name = "derive", .fn = sample_derive },        // Altitude, orvalho, índice de calor
+    { .name = "alarm", .fn = check_alarms },
+    { .name = "publish", .fn = sample_publish },      // Para o histórico no núcleo 0
+};
+pipeline_t sample_pipeline = PIPELINE_INIT(sample_stages);
 
 // ==================== DADOS ESTÁTICOS ====================
 
-// Matrizes para cada dígito 
+// Padrões do buzzer e do LED RGB, tocados pelo sequenciador sem bloquear
+static const seq_step_t SEQ_BEEP_BOOT[] = { { .tone_hz = BUZZER_TONE_HZ, .ms = 200 } };
+static const seq_step_t SEQ_BEEP_SHORT[] = { { .tone_hz = BUZZER_TONE_HZ, .ms = 50 } };
+static const seq_step_t SEQ_ALARM[] = {  // Vermelho aceso por um ciclo, com bipe no início
+    { .tone_hz = BUZZER_TONE_HZ, .ms = 100, .led = true, .r = LED_ON, .b = LED_ON },
+    { .ms = UPDATE_INTERVAL_MS - 100, .led = true, .r = LED_ON, .b = LED_ON },
+};
+static const seq_step_t SEQ_BOOTSEL[] = {  // Amarelo até o reset
+    { .tone_hz = BUZZER_TONE_HZ, .ms = 100, .led = true, .r = LED_ON, .g = LED_ON },
+    { .ms = BOOTSEL_DELAY_MS, .led = true, .r = LED_ON, .g = LED_ON },
+};
+
+// Matrizes para cada dígito (níveis perceptuais: 174 sai como ~110 pela np_gamma)
 const uint8_t digits[3][5][5][3] = {
     // Dígito 0
     {
-        {{0, 0, 0}, {0, 0, 110}, {0, 0, 110}, {0, 0, 110}, {0, 0, 0}}, 
-        {{0, 0, 110}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 110}},    
-        {{0, 0, 110}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 110}},    
-        {{0, 0, 110}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 110}},    
-        {{0, 0, 0}, {0, 0, 110}, {0, 0, 110}, {0, 0, 110}, {0, 0, 0}}  
+        {{0, 0, 0}, {0, 0, 174}, {0, 0, 174}, {0, 0, 174}, {0, 0, 0}}, 
+        {{0, 0, 174}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 174}},    
+        {{0, 0, 174}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 174}},    
+        {{0, 0, 174}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 174}},    
+        {{0, 0, 0}, {0, 0, 174}, {0, 0, 174}, {0, 0, 174}, {0, 0, 0}}  
     },
     // Dígito 1
     {
-        {{110, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {110, 0, 0}},
-        {{0, 0, 0}, {110, 0, 0}, {0, 0, 0}, {110, 0, 0}, {0, 0, 0}},
-        {{0, 0, 0}, {0, 0, 0}, {110, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-        {{0, 0, 0}, {110, 0, 0}, {0, 0, 0}, {110, 0, 0}, {0, 0, 0}},
-        {{110, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {110, 0, 0}}
+        {{174, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {174, 0, 0}},
+        {{0, 0, 0}, {174, 0, 0}, {0, 0, 0}, {174, 0, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 0, 0}, {174, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {174, 0, 0}, {0, 0, 0}, {174, 0, 0}, {0, 0, 0}},
+        {{174, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {174, 0, 0}}
     },
     // Dígito 2
     {
@@ -185,243 +472,32 @@ const uint8_t digits[3][5][5][3] = {
     }
 };
 
-// HTML da página web
-const char HTML_HEADER[] = 
-    "<!DOCTYPE html><html><head><meta charset='UTF-8'>"
-    "<meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-    "<title>Estação Meteorológica</title>"
-    "<style>"
-    "body { font-family: Arial, sans-serif; margin: 0; padding: 20px; background: #f5f5f5; }"
-    ".container { max-width: 1200px; margin: 0 auto; }"
-    ".card { background: white; padding: 20px; margin: 10px 0; border-radius: 8px; box-shadow: 0 2px 4px rgba(0,0,0,0.1); }"
-    ".sensor-grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(250px, 1fr)); gap: 20px; }"
-    ".sensor-card { text-align: center; padding: 20px; }"
-    ".sensor-value { font-size: 36px; font-weight: bold; margin: 10px 0; }"
-    ".sensor-label { color: #666; }"
-    ".temp { color: #ff6b6b; }"
-    ".humid { color: #4ecdc4; }"
-    ".press { color: #45b7d1; }"
-    ".charts { display: grid; grid-template-columns: 1fr; gap: 20px; margin-top: 20px; }"
-    ".chart-container { height: 200px; position: relative; }"
-    ".config-form { display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 15px; }"
-    ".form-group { display: flex; flex-direction: column; }"
-    ".form-group label { margin-bottom: 5px; color: #333; }"
-    ".form-group input { padding: 8px; border: 1px solid #ddd; border-radius: 4px; }"
-    ".btn { background: #4CAF50; color: white; padding: 10px 20px; border: none; border-radius: 4px; cursor: pointer; }"
-    ".btn:hover { background: #45a049; }"
-    ".alert { background: #ff6b6b; color: white; padding: 10px; border-radius: 4px; display: none; }"
-    ".alert.active { display: block; }"
-    "@media (max-width: 768px) { .sensor-value { font-size: 28px; } }"
-    "</style>"
-    "<script src='https://cdn.jsdelivr.net/npm/chart.js'></script>"
-    "</head><body>";
-
-const char HTML_BODY[] = 
-    "<div class='container'>"
-    "<h1>🌤️ Estação Meteorológica BitDogLab - Trabalho SE 11 - MPA</h1>"
-    "<div id='alert' class='alert'></div>"
-    
-    "<div class='card'>"
-    "<h2>Dados Atuais</h2>"
-    "<div class='sensor-grid'>"
-    "<div class='sensor-card'>"
-    "<div class='sensor-label'>Temperatura</div>"
-    "<div class='sensor-value temp' id='temp'>--</div>"
-    "<div class='sensor-label'>°C</div>"
-    "</div>"
-    "<div class='sensor-card'>"
-    "<div class='sensor-label'>Umidade</div>"
-    "<div class='sensor-value humid' id='humid'>--</div>"
-    "<div class='sensor-label'>%</div>"
-    "</div>"
-    "<div class='sensor-card'>"
-    "<div class='sensor-label'>Pressão</div>"
-    "<div class='sensor-value press' id='press'>--</div>"
-    "<div class='sensor-label'>hPa</div>"
-    "</div>"
-    "<div class='sensor-card'>"
-    "<div class='sensor-label'>Altitude</div>"
-    "<div class='sensor-value' id='alt'>--</div>"
-    "<div class='sensor-label'>m</div>"
-    "</div>"
-    "</div></div>"
-    
-    "<div class='card'>"
-    "<h2>Gráficos</h2>"
-    "<div class='charts'>"
-    "<div class='chart-container'><canvas id='tempChart'></canvas></div>"
-    "<div class='chart-container'><canvas id='humidChart'></canvas></div>"
-    "<div class='chart-container'><canvas id='pressChart'></canvas></div>"
-    "</div></div>"
-    
-    "<div class='card'>"
-    "<h2>Configurações</h2>"
-    "<form id='configForm' class='config-form'>"
-    "<div class='form-group'>"
-    "<label>Temp. Mínima (°C)</label>"
-    "<input type='number' id='temp_min' step='0.1'>"
-    "</div>"
-    "<div class='form-group'>"
-    "<label>Temp. Máxima (°C)</label>"
-    "<input type='number' id='temp_max' step='0.1'>"
-    "</div>"
-    "<div class='form-group'>"
-    "<label>Umidade Mínima (%)</label>"
-    "<input type='number' id='humid_min' step='0.1'>"
-    "</div>"
-    "<div class='form-group'>"
-    "<label>Umidade Máxima (%)</label>"
-    "<input type='number' id='humid_max' step='0.1'>"
-    "</div>"
-    "<div class='form-group'>"
-    "<label>Pressão Mínima (hPa)</label>"
-    "<input type='number' id='press_min' step='0.1'>"
-    "</div>"
-    "<div class='form-group'>"
-    "<label>Pressão Máxima (hPa)</label>"
-    "<input type='number' id='press_max' step='0.1'>"
-    "</div>"
-    "<div class='form-group'>"
-    "<label>Offset Temp. (°C)</label>"
-    "<input type='number' id='temp_offset' step='0.1'>"
-    "</div>"
-    "<div class='form-group'>"
-    "<label>Offset Umidade (%)</label>"
-    "<input type='number' id='humid_offset' step='0.1'>"
-    "</div>"
-    "<div class='form-group'>"
-    "<label>Offset Pressão (hPa)</label>"
-    "<input type='number' id='press_offset' step='0.1'>"
-    "</div>"
-    "</form>"
-    "<button class='btn' onclick='saveConfig()'>Salvar Configurações</button>"
-    "</div></div>";
-
-const char HTML_SCRIPT[] = 
-    "<script>"
-    "let tempChart, humidChart, pressChart;"
-    "let tempData = [], humidData = [], pressData = [];"
-    "let labels = [];"
-    
-    "function initCharts() {"
-    "  const chartOptions = {"
-    "    responsive: true,"
-    "    maintainAspectRatio: false,"
-    "    scales: {"
-    "      x: { display: false },"
-    "      y: { beginAtZero: false }"
-    "    },"
-    "    animation: { duration: 0 }"
-    "  };"
-    
-    "  tempChart = new Chart(document.getElementById('tempChart'), {"
-    "    type: 'line',"
-    "    data: {"
-    "      labels: labels,"
-    "      datasets: [{"
-    "        label: 'Temperatura (°C)',"
-    "        data: tempData,"
-    "        borderColor: '#ff6b6b',"
-    "        tension: 0.1"
-    "      }]"
-    "    },"
-    "    options: chartOptions"
-    "  });"
-    
-    "  humidChart = new Chart(document.getElementById('humidChart'), {"
-    "    type: 'line',"
-    "    data: {"
-    "      labels: labels,"
-    "      datasets: [{"
-    "        label: 'Umidade (%)',"
-    "        data: humidData,"
-    "        borderColor: '#4ecdc4',"
-    "        tension: 0.1"
-    "      }]"
-    "    },"
-    "    options: chartOptions"
-    "  });"
-    
-    "  pressChart = new Chart(document.getElementById('pressChart'), {"
-    "    type: 'line',"
-    "    data: {"
-    "      labels: labels,"
-    "      datasets: [{"
-    "        label: 'Pressão (hPa)',"
-    "        data: pressData,"
-    "        borderColor: '#45b7d1',"
-    "        tension: 0.1"
-    "      }]"
-    "    },"
-    "    options: chartOptions"
-    "  });"
-    "}"
-    
-    "function updateData() {"
-    "  fetch('/api/data').then(r => r.json()).then(data => {"
-    "    document.getElementById('temp').textContent = data.temperature.toFixed(1);"
-    "    document.getElementById('humid').textContent = data.humidity.toFixed(1);"
-    "    document.getElementById('press').textContent = data.pressure.toFixed(1);"
-    "    document.getElementById('alt').textContent = data.altitude.toFixed(1);"
-    
-    "    if (data.history) {"
-    "      tempData = data.history.temperature;"
-    "      humidData = data.history.humidity;"
-    "      pressData = data.history.pressure;"
-    "      labels = Array(tempData.length).fill('');"
-    
-    "      tempChart.data.labels = labels;"
-    "      tempChart.data.datasets[0].data = tempData;"
-    "      tempChart.update();"
-    
-    "      humidChart.data.labels = labels;"
-    "      humidChart.data.datasets[0].data = humidData;"
-    "      humidChart.update();"
-    
-    "      pressChart.data.labels = labels;"
-    "      pressChart.data.datasets[0].data = pressData;"
-    "      pressChart.update();"
-    "    }"
-    
-    "    if (data.alert) {"
-    "      document.getElementById('alert').textContent = data.alert;"
-    "      document.getElementById('alert').classList.add('active');"
-    "    } else {"
-    "      document.getElementById('alert').classList.remove('active');"
-    "    }"
-    "  });"
-    "}"
-    
-    "function loadConfig() {"
-    "  fetch('/api/config').then(r => r.json()).then(data => {"
-    "    Object.keys(data).forEach(key => {"
-    "      const el = document.getElementById(key);"
-    "      if (el) el.value = data[key];"
-    "    });"
-    "  });"
-    "}"
-    
-    "function saveConfig() {"
-    "  const config = {};"
-    "  ['temp_min', 'temp_max', 'humid_min', 'humid_max', 'press_min', 'press_max',"
-    "   'temp_offset', 'humid_offset', 'press_offset'].forEach(id => {"
-    "    config[id] = parseFloat(document.getElementById(id).value);"
-    "  });"
-    
-    "  fetch('/api/config', {"
-    "    method: 'POST',"
-    "    headers: { 'Content-Type': 'application/json' },"
-    "    body: JSON.stringify(config)"
-    "  }).then(() => alert('Configurações salvas!'));"
-    "}"
-    
-    "window.onload = () => {"
-    "  initCharts();"
-    "  loadConfig();"
-    "  updateData();"
-    "  setInterval(updateData, 1000);"
-    "};"
-    "</script></body></html>";
+// Início do fluxo Server-Sent Events; a conexão fica aberta recebendo eventos
+static const char HTTP_SSE_HEADER[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"
+    "retry: 3000\n\n";
+
+// Fim dos cabeçalhos gerados por tools/embed_assets.py
+static const char HTTP_CONN_KEEP_ALIVE[] = "Connection: keep-alive\r\n\r\n";
+static const char HTTP_CONN_CLOSE[] = "Connection: close\r\n\r\n";
+
+// Respostas de erro (a conexão é fechada em seguida)
+static const char HTTP_RESPONSE_400[] =
+    "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char HTTP_RESPONSE_405[] =
+    "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET, POST\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char HTTP_RESPONSE_414[] =
+    "HTTP/1.1 414 URI Too Long\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char HTTP_RESPONSE_413[] =
+    "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char HTTP_RESPONSE_503[] =
+    "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nRetry-After: 5\r\nConnection: close\r\n\r\n";
+static const char HTTP_RESPONSE_431[] =
+    "HTTP/1.1 431 Request Header Fields Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
 
 // ==================== FUNÇÃO PRINCIPAL ====================
 
@@ -429,67 +505,135 @@ int main() {
     stdio_init_all();
     sleep_ms(2000);
     
-    // Inicializações em ordem
+    // Núcleo 0: display só para as mensagens de boot, histórico e rede
+    init_i2c_display();
+    history_restore();  // Antes do WiFi: a leitura do log não concorre com a rede
+    init_wifi();
+    
+    // A partir daqui o núcleo 1 é dono de sensores, display, LEDs e buzzer
+    snapshot_write(&config_snapshot, &config);
+    sched_start(&net_sched, alarm_pool_get_default());  // Antes: o núcleo 1 já dispara tarefas aqui
+    multicore_launch_core1(core1_main);
+    
+    sched_run(&net_sched);
+}
+
+// Estado do WiFi para a página de status do display
+void network_task(void) {
+    net_ip = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP
+        ? cyw43_state.netif[0].ip_addr.addr : 0;
+    cyw43_arch_poll();
+}
+
+// Gravação/apagamento adiados do log só com a rede sem resposta em andamento
+void flash_task(void) {
+    if (history_log_ready) {
+        cyw43_arch_lwip_begin();
+        flash_log_service(&history_log, http_idle());
+        cyw43_arch_lwip_end();
+    }
+}
+
+// Botão B: grava os buckets ainda em RAM e entra no BOOTSEL
+void reboot_task(void) {
+    if (history_log_ready) {
+        cyw43_arch_lwip_begin();
+        flash_log_flush(&history_log);
+        cyw43_arch_lwip_end();
+    }
+    reset_usb_boot(0, 0);
+}
+
+// Núcleo 1: coleta dos sensores, alarmes, display e matriz; nada aqui espera pela rede
+void core1_main(void) {
+    flash_safe_execute_core_init();  // O núcleo 0 pausa este enquanto grava a flash
+    
+    // Pool próprio: os alarmes do escalonador, do sequenciador e da matriz
+    // precisam da IRQ neste núcleo
+    ui_pool = alarm_pool_create_with_unused_hardware_alarm(8);
+    
     init_led_matrix();
     init_gpio();
-    init_i2c_display();
     init_i2c_sensors();
     init_sensors();
-    init_wifi();
     
     // Calibração do BMP280
-    struct bmp280_calib_param bmp_params;
     bmp280_get_calib_params(I2C_PORT, &bmp_params);
     
+    seq_init(&seq, BUZZER_PIN, RED_PIN, GREEN_PIN, BLUE_PIN, ui_pool);
+    
+    // SysTick livre no clock do processador: conta os ciclos de cada estágio das amostras
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->csr = 0x5;  // ENABLE | CLKSOURCE
+    
     // Feedback de inicialização
-    buzzer_beep(200);
-    set_rgb_led(0, 0, 1);  // LED azul durante inicialização
+    seq_play(&seq, SEQ_BEEP_BOOT, count_of(SEQ_BEEP_BOOT));
+    seq_background(&seq, 0, 0, LED_ON);  // LED azul durante inicialização
     sleep_ms(500);
     
-    // Loop principal
-    uint32_t last_update = 0;
-    int32_t raw_temp_bmp, raw_pressure;
+    // Dispara as primeiras conversões; as seguintes são disparadas
+    // logo após cada coleta, então o loop nunca espera pelos sensores
+    aht20_trigger(I2C_PORT);
+    bmp280_trigger_forced(I2C_PORT);
+    
+    snapshot_read(&config_snapshot, &sensor_config);
     
-    while (1) {
-        uint32_t now = to_ms_since_boot(get_absolute_time());
+    sched_start(&ui_sched, ui_pool);
+    sched_run(&ui_sched);
+}
 
-        handle_buttons();
-        
-        if (now - last_update >= UPDATE_INTERVAL_MS) {
-            last_update = now;
-            
-            // Lê sensores
-            if (aht20_read(I2C_PORT, &sensor_data)) {
-                bmp280_read_raw(I2C_PORT, &raw_temp_bmp, &raw_pressure);
-                bmp_temperature = bmp280_convert_temp(raw_temp_bmp, &bmp_params) / 100.0;
-                bmp_pressure = bmp280_convert_pressure(raw_pressure, raw_temp_bmp, &bmp_params) / 100.0;
-                altitude = calculate_altitude(bmp_pressure * 100);
-                
-                // Processa dados
-                add_to_history(
-                    sensor_data.temperature + config.temp_offset,
-                    sensor_data.humidity + config.humid_offset,
-                    bmp_pressure + config.press_offset
-                );
-                
-                check_alarms();
-                update_display();
-                npDisplayDigit(digit);
-                
-                // Debug
-                printf("T=%.1f°C U=%.1f%% P=%.1fhPa A=%.1fm\n",
-                    sensor_data.temperature, sensor_data.humidity, 
-                    bmp_pressure, altitude);
-            }
-        }
-        
-        // Processa rede
-        cyw43_arch_poll();
-        sleep_ms(10);
+// Config nova vinda da API (vale a mais recente)
+void config_task(void) {
+    snapshot_read(&config_snapshot, &sensor_config);
+    seq_play(&seq, SEQ_BEEP_SHORT, count_of(SEQ_BEEP_SHORT));  // Feedback sonoro
+}
+
+void sensors_task(void) {
+    measurement_t m;
+    
+    if (!pipeline_run(&sample_pipeline, &m)) {
+        return;
     }
+    measured = m;
+    sched_trigger(&ui_sched, UI_TASK_DISPLAY);
+    sched_trigger(&ui_sched, UI_TASK_MATRIX);
     
-    cyw43_arch_deinit();
-    return 0;
+    // Debug
+    char t[12], u[12], p[12], a[12];
+    fixed_format(t, sizeof(t), m.temperature, MEASUREMENT_DECIMALS, 1);
+    fixed_format(u, sizeof(u), m.humidity, MEASUREMENT_DECIMALS, 1);
+    fixed_format(p, sizeof(p), m.pressure, MEASUREMENT_DECIMALS, 1);
+    fixed_format(a, sizeof(a), m.altitude, MEASUREMENT_DECIMALS, 1);
+    printf("T=%s°C U=%s%% P=%shPa A=%sm ciclos=%lu OLED=%luB (total %luB/%lu quadros) LEDs=%lu quadros (%lu iguais)\n",
+        t, u, p, a, (unsigned long)sample_pipeline.cycles,
+        (unsigned long)ssd.bytes_last_frame, (unsigned long)ssd.bytes_total,
+        (unsigned long)ssd.frames, (unsigned long)np_frames, (unsigned long)np_skipped);
+}
+
+void display_task(void) {
+    update_display();
+}
+
+void matrix_task(void) {
+    npDisplayDigit(digit);
+}
+
+// Fim da espera do botão B: o núcleo 0 grava o log e reinicia
+void bootsel_task(void) {
+    sched_trigger(&net_sched, NET_TASK_REBOOT);
+}
+
+// Núcleo 0: consome as amostras do núcleo 1, alimenta o histórico e o fluxo SSE
+void core0_receive_samples(void) {
+    SensorSample sample;
+    while (spsc_ring_pop(&sample_ring, &sample)) {
+        // Com a pilha travada os callbacks HTTP não rodam no meio da atualização
+        cyw43_arch_lwip_begin();
+        reading = sample;
+        add_to_history(&sample.value);
+        cyw43_arch_lwip_end();
+        http_sse_publish();
+    }
 }
 
 // ==================== IMPLEMENTAÇÃO DAS FUNÇÕES ====================
@@ -510,18 +654,7 @@ void init_gpio(void) {
     gpio_set_irq_enabled(BOTAO_B, GPIO_IRQ_EDGE_FALL, true);
     gpio_set_irq_callback(gpio_callback);
     irq_set_enabled(IO_IRQ_BANK0, true);
-    
-    // Inicializa buzzer
-    gpio_init(BUZZER_PIN);
-    gpio_set_dir(BUZZER_PIN, GPIO_OUT);
-    
-    // Inicializa LED RGB
-    gpio_init(RED_PIN);
-    gpio_set_dir(RED_PIN, GPIO_OUT);
-    gpio_init(GREEN_PIN);
-    gpio_set_dir(GREEN_PIN, GPIO_OUT);
-    gpio_init(BLUE_PIN);
-    gpio_set_dir(BLUE_PIN, GPIO_OUT);
+    // Buzzer e LED RGB ficam em PWM, configurados por seq_init
 }
 
 void init_i2c_display(void) {
@@ -547,7 +680,7 @@ void init_i2c_sensors(void) {
 }
 
 void init_sensors(void) {
-    bmp280_init(I2C_PORT);
+    bmp280_configure(I2C_PORT, &BMP280_PRESET);
     aht20_reset(I2C_PORT);
     aht20_init(I2C_PORT);
 }
@@ -598,13 +731,47 @@ void npSetLED(uint index, uint8_t r, uint8_t g, uint8_t b) {
     leds[index].B = b;
 }
 
+// Dispara o DMA do quadro; só com o latch do anterior já concluído
+static void np_start_frame(void) {
+    memcpy(np_sent, np_frame, sizeof(np_sent));
+    dma_channel_transfer_from_buffer_now(np_dma, np_sent, LED_COUNT);
+    np_ready_at = time_us_64() + NP_FRAME_US + NP_LATCH_US;
+    np_frames++;
+}
+
+static int64_t np_latch_callback(alarm_id_t id, void *user_data) {
+    np_pending = false;
+    np_start_frame();
+    return 0;
+}
+
+// Converte leds[] para GRB empacotado e envia por DMA. Quadro igual ao último
+// não sai; antes do fim do latch anterior, um alarme envia no instante certo.
 void npWrite(void) {
+    uint32_t frame[LED_COUNT];
     for (uint i = 0; i < LED_COUNT; i++) {
-        pio_sm_put_blocking(np_pio, sm, leds[i].G);
-        pio_sm_put_blocking(np_pio, sm, leds[i].R);
-        pio_sm_put_blocking(np_pio, sm, leds[i].B);
+        frame[i] = (uint32_t)np_gamma[leds[i].G] << 24 |
+                   (uint32_t)np_gamma[leds[i].R] << 16 |
+                   (uint32_t)np_gamma[leds[i].B] << 8;
     }
-    sleep_us(100);
+
+    // O alarme do latch roda na IRQ deste núcleo e copia np_frame: o teste de
+    // np_pending, a cópia e o novo alarme não podem ser interrompidos por ele
+    uint32_t irq = save_and_disable_interrupts();
+    if (!np_pending && memcmp(frame, np_sent, sizeof(frame)) == 0) {
+        np_skipped++;
+    } else {
+        memcpy(np_frame, frame, sizeof(frame));  // Com alarme armado, vale o mais novo
+        if (!np_pending) {
+            if (time_us_64() >= np_ready_at) {
+                np_start_frame();
+            } else {
+                np_pending = alarm_pool_add_alarm_at(ui_pool, from_us_since_boot(np_ready_at),
+                                                     np_latch_callback, NULL, true) > 0;
+            }
+        }
+    }
+    restore_interrupts(irq);
 }
 
 int getIndex(int x, int y) {
@@ -640,35 +807,193 @@ void npInit(uint pin) {
     np_pio = pio0;
     sm = pio_claim_unused_sm(np_pio, true);
     ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
+    
+    // Uma palavra por LED, no ritmo da FIFO do PIO
+    np_dma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(np_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(np_pio, sm, true));
+    dma_channel_configure(np_dma, &c, &np_pio->txf[sm], np_sent, 0, false);
+    
+    for (int i = 0; i < 256; i++) {
+        np_gamma[i] = (uint8_t)(powf(i / 255.0f, NP_GAMMA) * NP_BRIGHTNESS + 0.5f);
+    }
+    np_sent[0] = 1;  // Nunca é um quadro válido: o primeiro sempre sai
     npClear();
 }
 
-// ---------- Funções de Controle de Hardware ----------
+// ---------- Funções de Processamento de Dados ----------
+
+static int16_t history_to_fixed(int32_t value) {
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+// Relógio do histórico: segundos desde o boot somados ao ponto onde o log
+// parou (o tempo com a placa desligada não é contado). Em segundos ele
+// atravessa reboots por 136 anos; em ms de 32 bits voltaria a 0 em 49 dias.
+static uint32_t history_clock_s(void) {
+    return history_epoch_s + (uint32_t)(time_us_64() / 1000000);
+}
+
+// Acumula um intervalo (mín/máx/média; numa amostra os três são iguais) no
+// bucket aberto; ao cruzar o limite do período, fecha o bucket no anel e abre o próximo
+static void history_tier_add(HistoryTier *tier, uint32_t now, const int16_t *min,
+                             const int16_t *max, const int16_t *mean) {
+    if (tier->samples && now - tier->start_s >= tier->period_s) {
+        HistoryBucket *b = &tier->buckets[tier->total % tier->size];
+        b->time_s = tier->start_s;
+        for (int m = 0; m < HISTORY_METRICS; m++) {
+            int32_t half = tier->sum[m] < 0 ? -(tier->samples / 2) : tier->samples / 2;
+            b->min[m] = tier->min[m];
+            b->max[m] = tier->max[m];
+            b->mean[m] = (tier->sum[m] + half) / tier->samples;
+        }
+        tier->total++;
+        tier->samples = 0;
+    }
+
+    if (tier->samples == 0) {
+        tier->start_s = now - now % tier->period_s;
+        for (int m = 0; m < HISTORY_METRICS; m++) {
+            tier->sum[m] = 0;
+            tier->min[m] = INT16_MAX;
+            tier->max[m] = INT16_MIN;
+        }
+    }
+    for (int m = 0; m < HISTORY_METRICS; m++) {
+        tier->sum[m] += mean[m];
+        if (min[m] < tier->min[m]) {
+            tier->min[m] = min[m];
+        }
+        if (max[m] > tier->max[m]) {
+            tier->max[m] = max[m];
+        }
+    }
+    tier->samples++;
+}
+
+// Operações da flash pelo flash_safe_execute: com as interrupções paradas
+// enquanto o XIP está desligado
+typedef struct {
+    uint32_t offset;
+    const uint8_t *page;
+} history_flash_op_t;
+
+static void history_flash_erase_op(void *param) {
+    const history_flash_op_t *op = param;
+    flash_range_erase(HISTORY_LOG_OFFSET + op->offset, FLASH_SECTOR_SIZE);
+}
 
-void set_rgb_led(uint8_t r, uint8_t g, uint8_t b) {
-    gpio_put(RED_PIN, r);
-    gpio_put(GREEN_PIN, g);
-    gpio_put(BLUE_PIN, b);
+static void history_flash_program_op(void *param) {
+    const history_flash_op_t *op = param;
+    flash_range_program(HISTORY_LOG_OFFSET + op->offset, op->page, FLASH_PAGE_SIZE);
 }
 
-void buzzer_beep(int duration_ms) {
-    if (duration_ms > 0 && duration_ms < 1000) {
-        gpio_put(BUZZER_PIN, 1);
-        sleep_ms(duration_ms);
-        gpio_put(BUZZER_PIN, 0);
+static bool history_flash_erase(void *ctx, uint32_t offset) {
+    history_flash_op_t op = { offset, NULL };
+    return flash_safe_execute(history_flash_erase_op, &op, 100) == PICO_OK;
+}
+
+static bool history_flash_program(void *ctx, uint32_t offset, const uint8_t *page) {
+    history_flash_op_t op = { offset, page };
+    return flash_safe_execute(history_flash_program_op, &op, 100) == PICO_OK;
+}
+
+static const flash_log_backend_t history_flash = {
+    .base = (const uint8_t *)(XIP_BASE + HISTORY_LOG_OFFSET),
+    .sector_count = HISTORY_LOG_SECTORS,
+    .erase = history_flash_erase,
+    .program = history_flash_program,
+};
+
+// Reconstrói as camadas agregadas com os buckets do log e continua o relógio
+// do histórico a partir do último
+void history_restore(void) {
+    flash_log_iter_t it;
+    HistoryLogEntry e;
+    uint32_t seq;
+    uint32_t restored = 0;
+
+    if (!flash_log_open(&history_log, &history_flash)) {
+        printf("Log de histórico indisponível\n");
+        return;
     }
+    history_log_ready = true;
+
+    flash_log_seek(&history_log, &it, 0);
+    while (flash_log_next(&history_log, &it, &seq, &e)) {
+        HistoryBucket *b = &history_1m[history_tiers[0].total++ % HISTORY_1M_POINTS];
+        b->time_s = e.time_s;
+        memcpy(b->min, e.min, sizeof(b->min));
+        memcpy(b->max, e.max, sizeof(b->max));
+        memcpy(b->mean, e.mean, sizeof(b->mean));
+        history_tier_add(&history_tiers[1], b->time_s, b->min, b->max, b->mean);
+        restored++;
+    }
+    if (restored) {
+        history_epoch_s = e.time_s + history_tiers[0].period_s;
+        history_boot = e.boot + 1;
+    }
+    printf("Histórico: %lu buckets recuperados da flash (boot %u)\n",
+        (unsigned long)restored, history_boot);
 }
 
-// ---------- Funções de Processamento de Dados ----------
+// Grava um bucket de 1 minuto recém-fechado no log (vai para a flash por página).
+// Chamada com a pilha travada, como todo o add_to_history.
+static void history_log_bucket(const HistoryBucket *b) {
+    HistoryLogEntry e = { .time_s = b->time_s, .boot = history_boot };
 
-float calculate_altitude(float pressure) {
-    return 44330.0 * (1.0 - pow(pressure / SEA_LEVEL_PRESSURE, 0.1903));
+    if (!history_log_ready) {
+        return;
+    }
+    memcpy(e.min, b->min, sizeof(e.min));
+    memcpy(e.max, b->max, sizeof(e.max));
+    memcpy(e.mean, b->mean, sizeof(e.mean));
+    flash_log_append(&history_log, &e);
 }
 
-void add_to_history(float temp, float humid, float press) {
-    history.temperature[history.index] = temp;
-    history.humidity[history.index] = humid;
-    history.pressure[history.index] = press;
+void add_to_history(const measurement_t *m) {
+    history.temperature[history.index] = m->temperature;
+    history.humidity[history.index] = m->humidity;
+    history.pressure[history.index] = m->pressure;
+    history.seq[history.index] = history.next_seq++;
+    history.time_s[history.index] = history_clock_s();
+    
+    // Camadas agregadas: O(1) por amostra, independente do tamanho dos anéis
+    int16_t fixed[HISTORY_METRICS] = {  // Pressão em décimos de hPa para caber em 16 bits
+        history_to_fixed(m->temperature), history_to_fixed(m->humidity),
+        history_to_fixed(fixed_div_round(m->pressure, 10))
+    };
+    // Só a camada de 1 minuto recebe a amostra; cada bucket fechado alimenta
+    // a camada seguinte, a mesma regra do history_restore, então a média da
+    // hora pesa cada minuto igual com ou sem reboot no meio
+    uint32_t now = history.time_s[history.index];
+    const int16_t *min = fixed, *max = fixed, *mean = fixed;
+    for (size_t i = 0; i < HISTORY_TIER_COUNT; i++) {
+        HistoryTier *tier = &history_tiers[i];
+        uint32_t closed = tier->total;
+        history_tier_add(tier, now, min, max, mean);
+        if (tier->total == closed) {
+            break;
+        }
+        const HistoryBucket *b = &tier->buckets[closed % tier->size];
+        if (i == 0) {
+            history_log_bucket(b);
+        }
+        now = b->time_s;
+        min = b->min;
+        max = b->max;
+        mean = b->mean;
+    }
+    sample_store_append(&history_store, history.time_s[history.index], fixed);
     
     history.index = (history.index + 1) % MAX_DATA_POINTS;
     if (history.count < MAX_DATA_POINTS) {
@@ -676,40 +1001,120 @@ void add_to_history(float temp, float humid, float press) {
     }
 }
 
-void check_alarms(void) {
-    bool temp_alarm = (sensor_data.temperature < config.temp_min || 
-                      sensor_data.temperature > config.temp_max);
-    bool humid_alarm = (sensor_data.humidity < config.humid_min || 
-                       sensor_data.humidity > config.humid_max);
-    bool press_alarm = (bmp_pressure < config.press_min || 
-                       bmp_pressure > config.press_max);
+// Posição no anel da amostra com a sequência dada (precisa estar no histórico)
+static int history_slot(uint32_t seq) {
+    return (history.index - (int)(history.next_seq - seq) + MAX_DATA_POINTS) % MAX_DATA_POINTS;
+}
+
+// Coleta a conversão disparada no ciclo anterior e já dispara a próxima,
+// então a tarefa nunca espera pelos sensores. Sem dado novo do AHT20 a
+// amostra não sai; o BMP280 repete a última pressão se ainda não terminou.
+bool sample_capture(measurement_t *m) {
+    int32_t raw_temp_bmp, raw_pressure;
+    struct bmp280_reading bmp_reading;
+    
+    bool aht_ok = aht20_poll_ready(I2C_PORT) && aht20_collect(I2C_PORT, &sensor_data);
+    aht20_trigger(I2C_PORT);
+    
+    // BMP280: só lê os registradores se há uma conversão nova
+    if (bmp280_data_ready(I2C_PORT)) {
+        bmp280_read_raw(I2C_PORT, &raw_temp_bmp, &raw_pressure);
+        bmp280_compensate(raw_temp_bmp, raw_pressure, &bmp_params, &bmp_reading);
+        bmp_pressure = bmp_reading.pressure;
+    }
+    bmp280_trigger_forced(I2C_PORT);
     
-    alarm_active = temp_alarm || humid_alarm || press_alarm;
+    *m = (measurement_t){
+        .temperature = sensor_data.temperature,
+        .humidity = sensor_data.humidity,
+        .pressure = bmp_pressure,
+    };
+    return aht_ok;
+}
+
+// raw * gain / CALIBRATION_GAIN_ONE + offset, arredondado
+static int32_t calibrate(int32_t raw, int32_t gain, int32_t offset) {
+    int64_t v = (int64_t)raw * gain;
+    v = (v < 0 ? v - CALIBRATION_GAIN_ONE / 2 : v + CALIBRATION_GAIN_ONE / 2) / CALIBRATION_GAIN_ONE;
+    return (int32_t)v + offset;
+}
+
+bool sample_calibrate(measurement_t *m) {
+    m->temperature = calibrate(m->temperature, sensor_config.temp_gain, sensor_config.temp_offset);
+    m->humidity = calibrate(m->humidity, sensor_config.humid_gain, sensor_config.humid_offset);
+    m->pressure = calibrate(m->pressure, sensor_config.press_gain, sensor_config.press_offset);
+    return true;
+}
+
+// Média exponencial de temperatura, umidade e pressão. O acumulador guarda
+// SAMPLE_FILTER_SHIFT bits a mais; a primeira amostra o inicializa.
+bool sample_filter(measurement_t *m) {
+    static int32_t acc[3];
+    static bool primed = false;
+    int32_t *value[3] = { &m->temperature, &m->humidity, &m->pressure };
+    
+    for (int i = 0; i < 3; i++) {
+        if (!primed) {
+            acc[i] = *value[i] * (1 << SAMPLE_FILTER_SHIFT);
+        } else {
+            acc[i] += *value[i] - fixed_div_round(acc[i], 1 << SAMPLE_FILTER_SHIFT);
+        }
+        *value[i] = fixed_div_round(acc[i], 1 << SAMPLE_FILTER_SHIFT);
+    }
+    primed = true;
+    return true;
+}
+
+bool sample_derive(measurement_t *m) {
+    derived_compute(m, sensor_config.qnh);
+    return true;
+}
+
+// Entrega ao núcleo 0 (histórico, SSE); com a fila cheia a amostra não entra
+// no histórico, mas segue para o display
+bool sample_publish(measurement_t *m) {
+    SensorSample sample = { .value = *m, .alarm = alarm_active };
+    
+    if (spsc_ring_push(&sample_ring, &sample)) {
+        sched_trigger(&net_sched, NET_TASK_SAMPLES);
+    }
+    return true;
+}
+
+// Limites comparados com a amostra já calibrada e filtrada, a mesma que o
+// display e a API mostram
+bool check_alarms(measurement_t *m) {
+    bool temp_alarm = (m->temperature < sensor_config.temp_min || 
+                      m->temperature > sensor_config.temp_max);
+    bool humid_alarm = (m->humidity < sensor_config.humid_min || 
+                       m->humidity > sensor_config.humid_max);
+    bool press_alarm = (m->pressure < sensor_config.press_min || 
+                       m->pressure > sensor_config.press_max);
+    bool heat_alarm = m->heat_index > sensor_config.heat_max;
+    
+    alarm_active = temp_alarm || humid_alarm || press_alarm || heat_alarm;
     
     if (alarm_active) {
         static bool led_state = false;
         led_state = !led_state;
         
+        seq_background(&seq, 0, 0, LED_ON);  // Azul; o vermelho pisca com o padrão
         if (led_state) {
-            set_rgb_led(1, 0, 1);  // Vermelho + azul ligados
+            seq_play(&seq, SEQ_ALARM, count_of(SEQ_ALARM));
             digit = 1;
-        } else {
-            set_rgb_led(0, 0, 1);  // Só azul ligado (vermelho pisca)
-        }
-        
-        if (led_state) {
-            buzzer_beep(100);
         }
     } else {
-        set_rgb_led(0, 1, 1);  // Verde + azul fixo (operação normal)
+        seq_background(&seq, 0, LED_ON, LED_ON);  // Verde + azul fixo (operação normal)
         digit = 0;
     }
+    return true;
 }
 
 // ---------- Funções de Interface ----------
 
 void update_display(void) {
     char str[32];
+    char a[12], b[12];
     
     ssd1306_fill(&ssd, false);
     
@@ -718,16 +1123,20 @@ void update_display(void) {
             ssd1306_draw_string(&ssd, "ESTACAO", 20, 0);
             ssd1306_line(&ssd, 0, 10, 127, 10, true);
             
-            sprintf(str, "Temp: %.1fC", sensor_data.temperature + config.temp_offset);
+            fixed_format(a, sizeof(a), measured.temperature, MEASUREMENT_DECIMALS, 1);
+            sprintf(str, "Temp: %sC", a);
             ssd1306_draw_string(&ssd, str, 0, 15);
             
-            sprintf(str, "Umid: %.1f%%", sensor_data.humidity + config.humid_offset);
+            fixed_format(a, sizeof(a), measured.humidity, MEASUREMENT_DECIMALS, 1);
+            sprintf(str, "Umid: %s%%", a);
             ssd1306_draw_string(&ssd, str, 0, 25);
             
-            sprintf(str, "Pres: %.0fhPa", bmp_pressure + config.press_offset);
+            fixed_format(a, sizeof(a), measured.pressure, MEASUREMENT_DECIMALS, 0);
+            sprintf(str, "Pres: %shPa", a);
             ssd1306_draw_string(&ssd, str, 0, 35);
             
-            sprintf(str, "Alt: %.0fm", altitude);
+            fixed_format(a, sizeof(a), measured.altitude, MEASUREMENT_DECIMALS, 0);
+            sprintf(str, "Alt: %sm", a);
             ssd1306_draw_string(&ssd, str, 0, 45);
             
             if (alarm_active) {
@@ -739,15 +1148,25 @@ void update_display(void) {
             ssd1306_draw_string(&ssd, "LIMITES CONFIG", 15, 0);
             ssd1306_line(&ssd, 0, 10, 127, 10, true);
             
-            sprintf(str, "T: %.0f-%.0fC", config.temp_min, config.temp_max);
+            fixed_format(a, sizeof(a), sensor_config.temp_min, MEASUREMENT_DECIMALS, 0);
+            fixed_format(b, sizeof(b), sensor_config.temp_max, MEASUREMENT_DECIMALS, 0);
+            sprintf(str, "T: %s-%sC", a, b);
             ssd1306_draw_string(&ssd, str, 0, 15);
             
-            sprintf(str, "U: %.0f-%.0f%%", config.humid_min, config.humid_max);
+            fixed_format(a, sizeof(a), sensor_config.humid_min, MEASUREMENT_DECIMALS, 0);
+            fixed_format(b, sizeof(b), sensor_config.humid_max, MEASUREMENT_DECIMALS, 0);
+            sprintf(str, "U: %s-%s%%", a, b);
             ssd1306_draw_string(&ssd, str, 0, 25);
             
-            sprintf(str, "P: %.0f-%.0f", config.press_min, config.press_max);
+            fixed_format(a, sizeof(a), sensor_config.press_min, MEASUREMENT_DECIMALS, 0);
+            fixed_format(b, sizeof(b), sensor_config.press_max, MEASUREMENT_DECIMALS, 0);
+            sprintf(str, "P: %s-%s", a, b);
             ssd1306_draw_string(&ssd, str, 0, 35);
             
+            fixed_format(a, sizeof(a), sensor_config.heat_max, MEASUREMENT_DECIMALS, 0);
+            sprintf(str, "IC max: %sC", a);
+            ssd1306_draw_string(&ssd, str, 0, 45);
+            
             ssd1306_draw_string(&ssd, "Botao A: Voltar", 0, 55);
             break;
             
@@ -755,19 +1174,57 @@ void update_display(void) {
             ssd1306_draw_string(&ssd, "STATUS WIFI", 25, 0);
             ssd1306_line(&ssd, 0, 10, 127, 10, true);
             
-            if (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP) {
+            if (net_ip) {
+                uint32_t ip = net_ip;  // Publicado pelo núcleo 0 (ordem de bytes da rede)
                 ssd1306_draw_string(&ssd, "Conectado", 30, 20);
                 
-                uint8_t *ip = (uint8_t *)&(cyw43_state.netif[0].ip_addr.addr);
-                sprintf(str, "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+                sprintf(str, "%lu.%lu.%lu.%lu", (unsigned long)(ip & 0xFF), (unsigned long)((ip >> 8) & 0xFF),
+                    (unsigned long)((ip >> 16) & 0xFF), (unsigned long)(ip >> 24));
                 ssd1306_draw_string(&ssd, str, 15, 35);
             } else {
                 ssd1306_draw_string(&ssd, "Desconectado", 20, 25);
             }
             break;
+            
+        case 3:  // Página de leituras em destaque (fonte 16x24)
+            ssd1306_draw_string(&ssd, "Temperatura", 0, 0);
+            fixed_format(str, sizeof(str), measured.temperature, MEASUREMENT_DECIMALS, 1);
+            ssd1306_draw_string_font(&ssd, &ssd1306_font_16x24, str, 0, 8);
+            ssd1306_draw_string(&ssd, "C", 112, 16);
+            
+            ssd1306_draw_string(&ssd, "Umidade", 0, 32);
+            fixed_format(str, sizeof(str), measured.humidity, MEASUREMENT_DECIMALS, 1);
+            ssd1306_draw_string_font(&ssd, &ssd1306_font_16x24, str, 0, 40);
+            ssd1306_draw_string(&ssd, "%", 112, 48);
+            break;
+            
+        case 4:  // Página de grandezas derivadas
+            ssd1306_draw_string(&ssd, "CONFORTO", 30, 0);
+            ssd1306_line(&ssd, 0, 10, 127, 10, true);
+            
+            fixed_format(a, sizeof(a), measured.dew_point, MEASUREMENT_DECIMALS, 1);
+            sprintf(str, "Orvalho: %sC", a);
+            ssd1306_draw_string(&ssd, str, 0, 15);
+            
+            fixed_format(a, sizeof(a), measured.abs_humidity, MEASUREMENT_DECIMALS, 1);
+            sprintf(str, "U.abs: %sg/m3", a);
+            ssd1306_draw_string(&ssd, str, 0, 25);
+            
+            fixed_format(a, sizeof(a), measured.heat_index, MEASUREMENT_DECIMALS, 1);
+            sprintf(str, "Ind.calor: %sC", a);
+            ssd1306_draw_string(&ssd, str, 0, 35);
+            
+            fixed_format(a, sizeof(a), sensor_config.qnh, MEASUREMENT_DECIMALS, 0);
+            sprintf(str, "QNH: %shPa", a);
+            ssd1306_draw_string(&ssd, str, 0, 45);
+            break;
     }
     
-    ssd1306_send_data(&ssd);
+    // Envio por DMA: o loop principal e a rede seguem enquanto o painel atualiza.
+    // Com um envio ainda em curso o quadro é recusado: redesenha logo depois.
+    if (!ssd1306_flush_async(&ssd)) {
+        sched_after(&ui_sched, UI_TASK_DISPLAY, DISPLAY_RETRY_MS * 1000);
+    }
 }
 
 void gpio_callback(uint gpio, uint32_t events) {
@@ -783,14 +1240,16 @@ void gpio_callback(uint gpio, uint32_t events) {
     } else if (gpio == BOTAO_B) {
         button_b_pressed = true;
     }
+    sched_trigger(&ui_sched, UI_TASK_BUTTONS);
 }
 
 void handle_buttons(void) {
     if (button_a_pressed) {
         button_a_pressed = false;
         
-        current_page = (current_page + 1) % 3;
-        buzzer_beep(50);
+        current_page = (current_page + 1) % DISPLAY_PAGES;
+        sched_trigger(&ui_sched, UI_TASK_DISPLAY);  // Sem esperar a próxima leitura
+        seq_play(&seq, SEQ_BEEP_SHORT, count_of(SEQ_BEEP_SHORT));
         
         printf("Página alterada para: %d\n", current_page);
     }
@@ -798,181 +1257,1257 @@ void handle_buttons(void) {
     if (button_b_pressed) {
         button_b_pressed = false;
         
-        buzzer_beep(100);
-        set_rgb_led(1, 1, 0);
-        sleep_ms(500);
-        
-        reset_usb_boot(0, 0);
+        seq_play(&seq, SEQ_BOOTSEL, count_of(SEQ_BOOTSEL));
+        sched_after(&ui_sched, UI_TASK_BOOTSEL, BOOTSEL_DELAY_MS * 1000);
     }
 }
 
 // ---------- Funções do Servidor HTTP ----------
 
+// Procura o arquivo estático pela rota; rota desconhecida serve a página
+static const web_asset_t *find_web_asset(const char *path) {
+    for (int i = 0; i < WEB_ASSET_COUNT; i++) {
+        if (strcmp(path, web_assets[i].path) == 0) {
+            return &web_assets[i];
+        }
+    }
+    return &web_assets[0];
+}
+
+// Verifica se o valor do cabeçalho contém o texto (If-None-Match pode listar vários ETags)
+static bool header_contains(const char *value, const char *text) {
+    size_t n = strlen(text);
+    for (const char *c = value; *c; c++) {
+        if (strncasecmp(c, text, n) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Enfileira o quanto couber no buffer de envio; o restante segue em http_sent
+static void http_send_more(struct tcp_pcb *tpcb, struct http_state *hs) {
+    while (hs->chunk < hs->chunk_count) {
+        const http_chunk_t *c = &hs->chunks[hs->chunk];
+        size_t n = c->len - hs->offset;
+        u16_t space = tcp_sndbuf(tpcb);
+        if (space == 0) {
+            break;
+        }
+        if (n > space) {
+            n = space;
+        }
+
+        bool last = (hs->chunk + 1 == hs->chunk_count) && (hs->offset + n == c->len);
+        if (tcp_write(tpcb, c->data + hs->offset, n, last ? 0 : TCP_WRITE_FLAG_MORE) != ERR_OK) {
+            break;  // Fila do lwIP cheia: tenta de novo quando houver ACK
+        }
+
+        hs->offset += n;
+        if (hs->offset == c->len) {
+            hs->chunk++;
+            hs->offset = 0;
+        }
+    }
+    tcp_output(tpcb);
+}
+
+// Leitura atual (com offsets) como campos do objeto JSON aberto
+static void json_current_reading(json_writer_t *w) {
+    json_key(w, "temperature");
+    json_fixed(w, reading.value.temperature, MEASUREMENT_DECIMALS);
+    json_key(w, "humidity");
+    json_fixed(w, reading.value.humidity, MEASUREMENT_DECIMALS);
+    json_key(w, "pressure");
+    json_fixed(w, reading.value.pressure, MEASUREMENT_DECIMALS);
+    json_key(w, "altitude");
+    json_fixed(w, reading.value.altitude, MEASUREMENT_DECIMALS);
+    json_key(w, "dew_point");
+    json_fixed(w, reading.value.dew_point, MEASUREMENT_DECIMALS);
+    json_key(w, "abs_humidity");
+    json_fixed(w, reading.value.abs_humidity, MEASUREMENT_DECIMALS);
+    json_key(w, "heat_index");
+    json_fixed(w, reading.value.heat_index, MEASUREMENT_DECIMALS);
+}
+
+static void json_alert(json_writer_t *w) {
+    if (reading.alarm) {
+        json_key(w, "alert");
+        json_string(w, "Valores fora dos limites!");
+    }
+}
+
+// Clientes do fluxo /api/stream e o último evento publicado
+static struct http_state *sse_clients[HTTP_MAX_SSE_CLIENTS];
+static char sse_event[256];
+static size_t sse_event_len = 0;
+
+static bool sse_add(struct http_state *hs) {
+    for (int i = 0; i < HTTP_MAX_SSE_CLIENTS; i++) {
+        if (!sse_clients[i]) {
+            sse_clients[i] = hs;
+            hs->sse = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sse_remove(struct http_state *hs) {
+    for (int i = 0; hs->sse && i < HTTP_MAX_SSE_CLIENTS; i++) {
+        if (sse_clients[i] == hs) {
+            sse_clients[i] = NULL;
+        }
+    }
+}
+
+// Envia o último evento se o cliente tem espaço; senão só marca como pendente.
+// Um cliente lento recebe a amostra mais recente quando liberar espaço, e as
+// intermediárias são descartadas em vez de enfileiradas.
+static void sse_push(struct http_state *hs) {
+    size_t inflight = hs->len - hs->sent;
+    if (sse_event_len == 0) {
+        return;
+    }
+    if (hs->chunk < hs->chunk_count || inflight + sse_event_len > HTTP_SSE_MAX_INFLIGHT ||
+        tcp_sndbuf(hs->pcb) < sse_event_len) {
+        hs->sse_pending = true;
+        return;
+    }
+    if (tcp_write(hs->pcb, sse_event, sse_event_len, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        hs->sse_pending = true;
+        return;
+    }
+    hs->sse_pending = false;
+    hs->len += sse_event_len;
+    tcp_output(hs->pcb);
+}
+
+// Chamado pelo loop principal a cada nova amostra
+void http_sse_publish(void) {
+    // "data: " + JSON + "\n\n"; o escritor trabalha só no trecho do meio
+    json_writer_t w;
+    json_init(&w, sse_event + 6, sizeof(sse_event) - 8);
+    json_object_begin(&w);
+    json_current_reading(&w);
+    json_key(&w, "seq");
+    json_uint(&w, history.next_seq - 1);
+    json_key(&w, "time");
+    json_uint(&w, history.time_s[history_slot(history.next_seq - 1)]);
+    json_alert(&w);
+    json_object_end(&w);
+    if (!json_ok(&w)) {
+        sse_event_len = 0;
+        return;
+    }
+    memcpy(sse_event, "data: ", 6);
+    memcpy(sse_event + 6 + w.len, "\n\n", 2);
+    sse_event_len = w.len + 8;
+
+    // Fora dos callbacks do lwIP é preciso travar a pilha (threadsafe_background)
+    cyw43_arch_lwip_begin();
+    for (int i = 0; i < HTTP_MAX_SSE_CLIENTS; i++) {
+        if (sse_clients[i]) {
+            sse_push(sse_clients[i]);
+        }
+    }
+    cyw43_arch_lwip_end();
+}
+
+// Corpos JSON compartilhados (ver http_body_t)
+static http_body_t body_cache[HTTP_BODY_CACHE_SLOTS];
+
+static size_t format_data_json(char *buf, size_t cap, bool has_since, uint32_t since);
+static size_t format_config_json(char *buf, size_t cap);
+
+// Versão do corpo que reflete o estado atual; a config só depende de config_version
+static uint32_t body_seq(http_body_kind_t kind) {
+    return kind == HTTP_BODY_CONFIG ? 0 : history.next_seq - 1;
+}
+
+static bool body_current(const http_body_t *b) {
+    return b->len && b->seq == body_seq(b->kind) && b->config_version == config_version;
+}
+
+// Retorna o corpo atual do tipo pedido com uma referência a mais, gerando-o
+// só se ainda não existe. NULL se todos os slots estão presos em envios.
+static http_body_t *body_cache_get(http_body_kind_t kind) {
+    http_body_t *slot = NULL;
+    for (int i = 0; i < HTTP_BODY_CACHE_SLOTS; i++) {
+        http_body_t *b = &body_cache[i];
+        if (b->kind == kind && body_current(b)) {
+            b->refs++;
+            return b;
+        }
+        // Prefere reaproveitar um slot desatualizado a um atual de outro tipo
+        if (b->refs == 0 && (!slot || (body_current(slot) && !body_current(b)))) {
+            slot = b;
+        }
+    }
+    if (!slot) {
+        return NULL;
+    }
+
+    uint32_t seq = body_seq(kind);
+    switch (kind) {
+        case HTTP_BODY_DATA_FULL:
+            slot->len = format_data_json(slot->data, sizeof(slot->data), false, 0);
+            break;
+        case HTTP_BODY_DATA_DELTA:
+            slot->len = format_data_json(slot->data, sizeof(slot->data), true, seq - 1);
+            break;
+        case HTTP_BODY_CONFIG:
+            slot->len = format_config_json(slot->data, sizeof(slot->data));
+            break;
+        default:
+            return NULL;
+    }
+    if (slot->len == 0) {
+        return NULL;
+    }
+    slot->kind = kind;
+    slot->seq = seq;
+    slot->config_version = config_version;
+    slot->refs = 1;
+    return slot;
+}
+
+// Devolve o corpo da resposta concluída (ou abandonada)
+static void http_release_body(struct http_state *hs) {
+    if (hs->body) {
+        hs->body->refs--;
+        hs->body = NULL;
+    }
+    free(hs->response);
+    hs->response = NULL;
+    memset(&hs->stream, 0, sizeof(hs->stream));
+}
+
+// Prefixo "XXXX\r\n" e sufixo "\r\n" + "0\r\n\r\n" de cada pedaço chunked
+#define HTTP_CHUNK_PREFIX 6
+#define HTTP_CHUNK_SUFFIX 7
+
+// Gera o próximo trecho do stream em hs->response e o enfileira. Só é chamado
+// com tudo confirmado pelo cliente, então o buffer pode ser reescrito.
+static bool http_stream_next(struct http_state *hs) {
+    http_stream_t *st = &hs->stream;
+    if (!st->producer || st->done) {
+        return false;
+    }
+
+    char *buf = hs->response;
+    size_t prefix = st->chunked ? HTTP_CHUNK_PREFIX : 0;
+    size_t suffix = st->chunked ? HTTP_CHUNK_SUFFIX : 0;
+    size_t n = st->producer(hs, buf + prefix, HTTP_RESPONSE_SIZE - prefix - suffix);
+    if (n == 0) {
+        st->done = true;  // Nada coube num buffer vazio: encerra em vez de repetir
+    }
+
+    size_t len = 0;
+    if (st->chunked) {
+        if (n) {
+            static const char hex[] = "0123456789abcdef";
+            for (int i = 0; i < 4; i++) {
+                buf[i] = hex[(n >> (12 - 4 * i)) & 0xF];
+            }
+            memcpy(buf + 4, "\r\n", 2);
+            memcpy(buf + prefix + n, "\r\n", 2);
+            len = prefix + n + 2;
+        }
+        if (st->done) {
+            memcpy(buf + len, "0\r\n\r\n", 5);
+            len += 5;
+        }
+    } else {
+        len = n;
+    }
+    if (len == 0) {
+        return false;
+    }
+
+    if (hs->chunk == hs->chunk_count) {
+        hs->chunk = hs->chunk_count = 0;
+        hs->offset = 0;
+    }
+    hs->chunks[hs->chunk_count++] = (http_chunk_t){ buf, len };
+    hs->len += len;
+    return true;
+}
+
+// Slots de conexão alocados estaticamente; a lista livre dá acquire/release O(1)
+static struct http_state http_pool[HTTP_MAX_CONNECTIONS];
+static struct http_state *http_free_list;
+
+// Ocupação e rejeições do pool (expostas em /api/stats)
+static struct {
+    uint16_t in_use;
+    uint16_t peak;
+    uint32_t accepted;
+    uint32_t rejected;
+} http_pool_stats;
+
+static void http_pool_init(void) {
+    http_free_list = NULL;
+    for (int i = HTTP_MAX_CONNECTIONS - 1; i >= 0; i--) {
+        http_pool[i].pcb = NULL;
+        http_pool[i].next_free = http_free_list;
+        http_free_list = &http_pool[i];
+    }
+}
+
+static struct http_state *http_pool_acquire(struct tcp_pcb *pcb) {
+    struct http_state *hs = http_free_list;
+    if (!hs) {
+        http_pool_stats.rejected++;
+        return NULL;
+    }
+    http_free_list = hs->next_free;
+    memset(hs, 0, sizeof(*hs));
+    hs->pcb = pcb;
+    http_parser_reset(&hs->parser);
+
+    http_pool_stats.accepted++;
+    if (++http_pool_stats.in_use > http_pool_stats.peak) {
+        http_pool_stats.peak = http_pool_stats.in_use;
+    }
+    return hs;
+}
+
+static void http_pool_release(struct http_state *hs) {
+    hs->pcb = NULL;
+    hs->next_free = http_free_list;
+    http_free_list = hs;
+    http_pool_stats.in_use--;
+}
+
+// Nenhuma resposta em envio. Conexões paradas em keep-alive não contam; um
+// fluxo SSE fica busy enquanto aberto, então só conta com eventos sem ACK.
+bool http_idle(void) {
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        const struct http_state *hs = &http_pool[i];
+        if (hs->pcb && (hs->sse ? hs->sent < hs->len : hs->busy)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Libera o estado da conexão e fecha o PCB. Retorna ERR_ABRT se precisou abortar.
+static err_t http_close(struct http_state *hs) {
+    struct tcp_pcb *tpcb = hs->pcb;
+    err_t ret = ERR_OK;
+
+    tcp_arg(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+    tcp_err(tpcb, NULL);
+    sse_remove(hs);
+    if (tcp_close(tpcb) != ERR_OK) {
+        tcp_abort(tpcb);
+        ret = ERR_ABRT;
+    }
+
+    if (hs->rx) {
+        pbuf_free(hs->rx);
+    }
+    http_release_body(hs);
+    http_pool_release(hs);
+    return ret;
+}
+
+// Prepara uma resposta fixa de erro; a conexão fecha ao final
+static void http_set_error(struct http_state *hs, const char *response) {
+    hs->chunks[0] = (http_chunk_t){ response, strlen(response) };
+    hs->chunk_count = 1;
+    hs->len = hs->chunks[0].len;
+    hs->close_after = true;
+}
+
+// Envia uma resposta fixa de erro e fecha a conexão ao final
+static void http_send_error(struct http_state *hs, const char *response) {
+    http_set_error(hs, response);
+    hs->busy = true;
+    http_send_more(hs->pcb, hs);
+}
+
+// Corpo de /api/data. Com since, traz só as amostras com seq > since; se o cliente
+// ficou para trás do anel (ou a placa reiniciou), manda tudo com "reset":true.
+// Retorna o tamanho do JSON ou 0 se não coube.
+static size_t format_data_json(char *buf, size_t cap, bool has_since, uint32_t since) {
+    uint32_t oldest = history.next_seq - history.count;
+    bool reset = !has_since || since + 1 < oldest || since >= history.next_seq;
+    uint32_t first = reset ? oldest : since + 1;
+    json_writer_t w;
+
+    json_init(&w, buf, cap);
+    json_object_begin(&w);
+    json_current_reading(&w);
+    json_key(&w, "seq");
+    json_uint(&w, history.next_seq - 1);
+    json_key(&w, "uptime");
+    json_uint(&w, history_clock_s());
+    json_key(&w, "reset");
+    json_bool(&w, reset);
+
+    json_key(&w, "history");
+    json_object_begin(&w);
+    json_key(&w, "time");
+    json_array_begin(&w);
+    for (uint32_t seq = first; seq < history.next_seq; seq++) {
+        json_uint(&w, history.time_s[history_slot(seq)]);
+    }
+    json_array_end(&w);
+    json_key(&w, "temperature");
+    json_array_begin(&w);
+    for (uint32_t seq = first; seq < history.next_seq; seq++) {
+        json_fixed(&w, fixed_div_round(history.temperature[history_slot(seq)], 10), 1);
+    }
+    json_array_end(&w);
+    json_key(&w, "humidity");
+    json_array_begin(&w);
+    for (uint32_t seq = first; seq < history.next_seq; seq++) {
+        json_fixed(&w, fixed_div_round(history.humidity[history_slot(seq)], 10), 1);
+    }
+    json_array_end(&w);
+    json_key(&w, "pressure");
+    json_array_begin(&w);
+    for (uint32_t seq = first; seq < history.next_seq; seq++) {
+        json_fixed(&w, fixed_div_round(history.pressure[history_slot(seq)], 10), 1);
+    }
+    json_array_end(&w);
+    json_object_end(&w);
+
+    json_alert(&w);
+    json_object_end(&w);
+    return json_ok(&w) ? w.len : 0;
+}
+
+static size_t format_config_json(char *buf, size_t cap) {
+    json_writer_t w;
+
+    json_init(&w, buf, cap);
+    json_object_begin(&w);
+    json_key(&w, "temp_min");
+    json_fixed(&w, config.temp_min, MEASUREMENT_DECIMALS);
+    json_key(&w, "temp_max");
+    json_fixed(&w, config.temp_max, MEASUREMENT_DECIMALS);
+    json_key(&w, "humid_min");
+    json_fixed(&w, config.humid_min, MEASUREMENT_DECIMALS);
+    json_key(&w, "humid_max");
+    json_fixed(&w, config.humid_max, MEASUREMENT_DECIMALS);
+    json_key(&w, "press_min");
+    json_fixed(&w, config.press_min, MEASUREMENT_DECIMALS);
+    json_key(&w, "press_max");
+    json_fixed(&w, config.press_max, MEASUREMENT_DECIMALS);
+    json_key(&w, "temp_offset");
+    json_fixed(&w, config.temp_offset, MEASUREMENT_DECIMALS);
+    json_key(&w, "humid_offset");
+    json_fixed(&w, config.humid_offset, MEASUREMENT_DECIMALS);
+    json_key(&w, "press_offset");
+    json_fixed(&w, config.press_offset, MEASUREMENT_DECIMALS);
+    json_key(&w, "temp_gain");
+    json_fixed(&w, config.temp_gain, CALIBRATION_GAIN_DECIMALS);
+    json_key(&w, "humid_gain");
+    json_fixed(&w, config.humid_gain, CALIBRATION_GAIN_DECIMALS);
+    json_key(&w, "press_gain");
+    json_fixed(&w, config.press_gain, CALIBRATION_GAIN_DECIMALS);
+    json_key(&w, "qnh");
+    json_fixed(&w, config.qnh, MEASUREMENT_DECIMALS);
+    json_key(&w, "heat_max");
+    json_fixed(&w, config.heat_max, MEASUREMENT_DECIMALS);
+    json_object_end(&w);
+    return json_ok(&w) ? w.len : 0;
+}
+
+// Resposta JSON: 304 se o cliente já tem esta versão; senão cabeçalho próprio
+// da conexão + corpo compartilhado do cache (ou gerado só para ela)
+static bool http_json_response(struct http_state *hs, const http_parser_t *req, const char *etag,
+                               http_body_kind_t kind, uint32_t since) {
+    const char *conn = hs->close_after ? "close" : "keep-alive";
+    const char *body;
+    size_t body_len;
+
+    if (header_contains(req->if_none_match, etag)) {
+        hs->len = snprintf(hs->header, sizeof(hs->header),
+            "HTTP/1.1 304 Not Modified\r\n"
+            "ETag: %s\r\n"
+            "Connection: %s\r\n"
+            "\r\n",
+            etag, conn);
+        hs->chunks[0] = (http_chunk_t){ hs->header, hs->len };
+        hs->chunk_count = 1;
+        return true;
+    }
+
+    hs->body = body_cache_get(kind);
+    if (hs->body) {
+        body = hs->body->data;
+        body_len = hs->body->len;
+    } else {
+        // since antigo, ou todos os slots presos em envios lentos
+        hs->response = malloc(HTTP_RESPONSE_SIZE);
+        if (!hs->response) {
+            return false;
+        }
+        if (kind == HTTP_BODY_CONFIG) {
+            body_len = format_config_json(hs->response, HTTP_RESPONSE_SIZE);
+        } else {
+            body_len = format_data_json(hs->response, HTTP_RESPONSE_SIZE, kind != HTTP_BODY_DATA_FULL, since);
+        }
+        if (body_len == 0) {
+            return false;
+        }
+        body = hs->response;
+    }
+
+    int header_len = snprintf(hs->header, sizeof(hs->header),
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: %u\r\n"
+        "Cache-Control: no-cache\r\n"
+        "ETag: %s\r\n"
+        "Connection: %s\r\n"
+        "\r\n",
+        (unsigned)body_len, etag, conn);
+    hs->chunks[0] = (http_chunk_t){ hs->header, header_len };
+    hs->chunks[1] = (http_chunk_t){ body, body_len };
+    hs->chunk_count = 2;
+    hs->len = header_len + body_len;
+    return true;
+}
+
+// Valor de um parâmetro da query ("since=12&res=1m"); NULL se ausente
+static const char *query_find(const char *query, const char *name) {
+    size_t n = strlen(name);
+    for (const char *q = query; q; q = strchr(q, '&')) {
+        if (*q == '&') {
+            q++;
+        }
+        if (strncmp(q, name, n) == 0 && q[n] == '=') {
+            return q + n + 1;
+        }
+    }
+    return NULL;
+}
+
+// Valor numérico de um parâmetro da query; false se ausente
+static bool query_param(const char *query, const char *name, uint32_t *value) {
+    const char *v = query_find(query, name);
+    if (v) {
+        *value = strtoul(v, NULL, 10);
+    }
+    return v != NULL;
+}
+
+// Compara o valor de um parâmetro (até '&' ou fim) com o texto
+static bool query_is(const char *value, const char *text) {
+    size_t n = strlen(text);
+    return value && strncmp(value, text, n) == 0 && (value[n] == '\0' || value[n] == '&');
+}
+
+// GET /api/data[?since=<seq>]: o painel só pede as amostras que ainda não tem
+static bool http_get_data(struct http_state *hs, const http_parser_t *req) {
+    uint32_t since = 0;
+    bool has_since = query_param(req->query, "since", &since);
+    uint32_t seq = history.next_seq - 1;
+    char etag[32];
+
+    // Mesma amostra e mesma config (offsets) geram o mesmo corpo
+    snprintf(etag, sizeof(etag), "\"d%lu.%lu\"", (unsigned long)seq, (unsigned long)config_version);
+
+    http_body_kind_t kind = HTTP_BODY_DATA_SINCE;
+    if (!has_since) {
+        kind = HTTP_BODY_DATA_FULL;
+    } else if (history.count && since + 1 == seq) {
+        kind = HTTP_BODY_DATA_DELTA;  // Caso comum: o cliente só perdeu a última amostra
+    }
+    return http_json_response(hs, req, etag, kind, since);
+}
+
+static bool http_get_config(struct http_state *hs, const http_parser_t *req) {
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"c%lu\"", (unsigned long)config_version);
+    return http_json_response(hs, req, etag, HTTP_BODY_CONFIG, 0);
+}
+
+// Campos de POST /api/config: °C, % e hPa em decimal, guardados com 2 casas;
+// ganhos com 4
+static const struct {
+    const char *key;
+    size_t offset;
+    uint8_t decimals;
+} config_fields[] = {
+    { "\"temp_min\"", offsetof(Config, temp_min), MEASUREMENT_DECIMALS },
+    { "\"temp_max\"", offsetof(Config, temp_max), MEASUREMENT_DECIMALS },
+    { "\"humid_min\"", offsetof(Config, humid_min), MEASUREMENT_DECIMALS },
+    { "\"humid_max\"", offsetof(Config, humid_max), MEASUREMENT_DECIMALS },
+    { "\"press_min\"", offsetof(Config, press_min), MEASUREMENT_DECIMALS },
+    { "\"press_max\"", offsetof(Config, press_max), MEASUREMENT_DECIMALS },
+    { "\"temp_offset\"", offsetof(Config, temp_offset), MEASUREMENT_DECIMALS },
+    { "\"humid_offset\"", offsetof(Config, humid_offset), MEASUREMENT_DECIMALS },
+    { "\"press_offset\"", offsetof(Config, press_offset), MEASUREMENT_DECIMALS },
+    { "\"temp_gain\"", offsetof(Config, temp_gain), CALIBRATION_GAIN_DECIMALS },
+    { "\"humid_gain\"", offsetof(Config, humid_gain), CALIBRATION_GAIN_DECIMALS },
+    { "\"press_gain\"", offsetof(Config, press_gain), CALIBRATION_GAIN_DECIMALS },
+    { "\"qnh\"", offsetof(Config, qnh), MEASUREMENT_DECIMALS },
+    { "\"heat_max\"", offsetof(Config, heat_max), MEASUREMENT_DECIMALS },
+};
+
+static bool http_post_config(struct http_state *hs, const http_parser_t *req) {
+    const char *conn = hs->close_after ? "close" : "keep-alive";
+    Config parsed = config;  // Campos ausentes mantêm o valor atual
+    int found = 0;
+
+    // Parse JSON numa cópia: config só muda inteira
+    for (size_t i = 0; i < sizeof(config_fields) / sizeof(config_fields[0]); i++) {
+        const char *p = strstr(req->body, config_fields[i].key);
+        if (!p) {
+            continue;
+        }
+        p += strlen(config_fields[i].key);
+        while (*p == ' ' || *p == ':') {
+            p++;
+        }
+        if (fixed_parse(p, config_fields[i].decimals, (int32_t *)((char *)&parsed + config_fields[i].offset))) {
+            found++;
+        }
+    }
+    if (found) {
+        config = parsed;
+        config_version++;  // Invalida os corpos em cache e os ETags
+        snapshot_write(&config_snapshot, &config);
+        sched_trigger(&ui_sched, UI_TASK_CONFIG);   // O núcleo 1 aplica (e dá o bipe)
+    }
+
+    hs->len = snprintf(hs->header, sizeof(hs->header),
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 2\r\n"
+        "Connection: %s\r\n"
+        "\r\n"
+        "OK", conn);
+    hs->chunks[0] = (http_chunk_t){ hs->header, hs->len };
+    hs->chunk_count = 1;
+    return true;
+}
+
+// /api/stream: a conexão passa a só receber eventos
+static bool http_get_stream(struct http_state *hs, const http_parser_t *req) {
+    if (!sse_add(hs)) {
+        http_set_error(hs, HTTP_RESPONSE_503);
+        return true;
+    }
+    hs->chunks[0] = (http_chunk_t){ HTTP_SSE_HEADER, sizeof(HTTP_SSE_HEADER) - 1 };
+    hs->chunk_count = 1;
+    hs->len = hs->chunks[0].len;
+    return true;
+}
+
+// Ociosidade e tarefas de um escalonador. Os contadores do outro núcleo são
+// palavras de 32 bits: cada uma vem inteira, mesmo lida no meio de uma tarefa.
+static void json_sched(json_writer_t *w, const sched_t *s) {
+    json_object_begin(w);
+    json_key(w, "idle_ms");
+    json_uint(w, s->idle_ms);
+    json_key(w, "wakeups");
+    json_uint(w, s->wakeups);
+    json_key(w, "tasks");
+    json_array_begin(w);
+    for (uint8_t i = 0; i < s->count; i++) {
+        const sched_task_t *t = &s->tasks[i];
+        json_object_begin(w);
+        json_key(w, "name");
+        json_string(w, t->name);
+        json_key(w, "period_ms");
+        json_uint(w, t->period_us / 1000);
+        json_key(w, "runs");
+        json_uint(w, t->runs);
+        json_key(w, "overruns");
+        json_uint(w, t->overruns);
+        json_key(w, "busy_ms");
+        json_uint(w, t->busy_ms);
+        json_key(w, "max_us");
+        json_uint(w, t->max_us);
+        json_key(w, "max_late_us");
+        json_uint(w, t->max_late_us);
+        json_object_end(w);
+    }
+    json_array_end(w);
+    json_object_end(w);
+}
+
+// Estágios do processamento de amostras do núcleo 1, em ciclos do SysTick
+static void json_pipeline(json_writer_t *w, const pipeline_t *p) {
+    json_object_begin(w);
+    json_key(w, "samples");
+    json_uint(w, p->samples);
+    json_key(w, "cycles");
+    json_uint(w, p->cycles);
+    json_key(w, "max_cycles");
+    json_uint(w, p->cycles_max);
+    json_key(w, "stages");
+    json_array_begin(w);
+    for (uint8_t i = 0; i < p->count; i++) {
+        const pipeline_stage_t *st = &p->stages[i];
+        json_object_begin(w);
+        json_key(w, "name");
+        json_string(w, st->name);
+        json_key(w, "runs");
+        json_uint(w, st->runs);
+        json_key(w, "stops");
+        json_uint(w, st->stops);
+        json_key(w, "cycles");
+        json_uint(w, st->cycles);
+        json_key(w, "max_cycles");
+        json_uint(w, st->cycles_max);
+        json_object_end(w);
+    }
+    json_array_end(w);
+    json_object_end(w);
+}
+
+// GET /api/stats: pool de conexões, histórico, log, escalonadores e pipeline
+static bool http_get_stats(struct http_state *hs, const http_parser_t *req) {
+    const char *conn = hs->close_after ? "close" : "keep-alive";
+    json_writer_t w;
+
+    hs->response = malloc(HTTP_RESPONSE_SIZE);
+    if (!hs->response) {
+        return false;
+    }
+    json_init(&w, hs->response, HTTP_RESPONSE_SIZE);
+    json_object_begin(&w);
+    json_key(&w, "connections");
+    json_object_begin(&w);
+    json_key(&w, "in_use");
+    json_uint(&w, http_pool_stats.in_use);
+    json_key(&w, "max");
+    json_uint(&w, HTTP_MAX_CONNECTIONS);
+    json_key(&w, "peak");
+    json_uint(&w, http_pool_stats.peak);
+    json_key(&w, "accepted");
+    json_uint(&w, http_pool_stats.accepted);
+    json_key(&w, "rejected");
+    json_uint(&w, http_pool_stats.rejected);
+    json_object_end(&w);
+    json_key(&w, "history");
+    json_object_begin(&w);
+    json_key(&w, "samples");
+    json_uint(&w, sample_store_count(&history_store));
+    json_key(&w, "bytes");
+    json_uint(&w, sample_store_bytes(&history_store));
+    json_object_end(&w);
+    json_key(&w, "log");
+    json_object_begin(&w);
+    json_key(&w, "oldest");
+    json_uint(&w, history_log_ready ? flash_log_oldest(&history_log) : 0);
+    json_key(&w, "next");
+    json_uint(&w, history_log.next_seq);
+    json_key(&w, "pages");
+    json_uint(&w, history_log.pages_written);
+    json_key(&w, "erases");
+    json_uint(&w, history_log.sectors_erased);
+    json_object_end(&w);
+    json_key(&w, "cores");
+    json_array_begin(&w);
+    json_sched(&w, &net_sched);
+    json_sched(&w, &ui_sched);
+    json_array_end(&w);
+    json_key(&w, "pipeline");
+    json_pipeline(&w, &sample_pipeline);
+    json_object_end(&w);
+    if (!json_ok(&w)) {
+        return false;
+    }
+
+    int header_len = snprintf(hs->header, sizeof(hs->header),
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: %u\r\n"
+        "Cache-Control: no-store\r\n"
+        "Connection: %s\r\n"
+        "\r\n",
+        (unsigned)w.len, conn);
+    hs->chunks[0] = (http_chunk_t){ hs->header, header_len };
+    hs->chunks[1] = (http_chunk_t){ hs->response, w.len };
+    hs->chunk_count = 2;
+    hs->len = header_len + w.len;
+    return true;
+}
+
+// Arquivos do painel (gzip, direto da flash)
+static bool http_get_asset(struct http_state *hs, const http_parser_t *req) {
+    const web_asset_t *asset = find_web_asset(req->path);
+    if (header_contains(req->if_none_match, asset->etag)) {
+        hs->chunks[0] = (http_chunk_t){ asset->header_304, asset->header_304_len };
+        hs->chunk_count = 2;
+    } else {
+        hs->chunks[0] = (http_chunk_t){ asset->header_200, asset->header_200_len };
+        hs->chunks[2] = (http_chunk_t){ (const char *)asset->body, asset->body_len };
+        hs->chunk_count = 3;
+    }
+    hs->chunks[1] = hs->close_after
+        ? (http_chunk_t){ HTTP_CONN_CLOSE, sizeof(HTTP_CONN_CLOSE) - 1 }
+        : (http_chunk_t){ HTTP_CONN_KEEP_ALIVE, sizeof(HTTP_CONN_KEEP_ALIVE) - 1 };
+    hs->len = hs->chunks[0].len + hs->chunks[1].len + (hs->chunk_count == 3 ? hs->chunks[2].len : 0);
+    return true;
+}
+
+static const char *const history_metric_names[HISTORY_METRICS] = { "temperature", "humidity", "pressure" };
+static const uint8_t history_metric_decimals[HISTORY_METRICS] = { 2, 2, 1 };
+static const char *const history_stat_names[] = { "mean", "min", "max" };
+
+static void history_stream_open(json_writer_t *w, const char *res, uint32_t period_s) {
+    json_object_begin(w);
+    json_key(w, "res");
+    json_string(w, res);
+    json_key(w, "period");
+    json_uint(w, period_s);
+    json_key(w, "uptime");
+    json_uint(w, history_clock_s());
+}
+
+// Escreve um passo do JSON de uma camada agregada: abertura, um valor, ou
+// fechamento de um array. Cada campo é um array com todos os buckets.
+static void history_tier_step(http_stream_t *st, json_writer_t *w) {
+    const HistoryTier *tier = &history_tiers[st->source - 1];
+    const unsigned stats = sizeof(history_stat_names) / sizeof(history_stat_names[0]);
+    unsigned fields = 1 + HISTORY_METRICS * stats;  // time + métricas
+    unsigned metric = st->field ? (st->field - 1) / stats : 0;
+    unsigned stat = st->field ? (st->field - 1) % stats : 0;
+
+    if (!st->started) {
+        history_stream_open(w, tier->period_s == 60 ? "1m" : "1h", tier->period_s);
+        st->started = true;
+        return;
+    }
+    if (st->field == fields) {
+        json_object_end(w);
+        st->done = true;
+        return;
+    }
+    if (!st->opened) {
+        if (st->field == 0) {
+            json_key(w, "time");
+        } else {
+            if (stat == 0) {
+                json_key(w, history_metric_names[metric]);
+                json_object_begin(w);
+            }
+            json_key(w, history_stat_names[stat]);
+        }
+        json_array_begin(w);
+        st->opened = true;
+        return;
+    }
+    if (st->pos < st->count) {
+        const HistoryBucket *b = &tier->buckets[(st->first + st->pos++) % tier->size];
+        const int16_t *values[] = { b->mean, b->min, b->max };
+        if (st->field == 0) {
+            json_uint(w, b->time_s);
+        } else {
+            json_fixed(w, values[stat][metric], history_metric_decimals[metric]);
+        }
+        return;
+    }
+    json_array_end(w);
+    if (st->field && stat == stats - 1) {
+        json_object_end(w);
+    }
+    st->field++;
+    st->pos = 0;
+    st->opened = false;
+}
+
+// Passo do histórico bruto: decodifica o store comprimido em ordem, uma
+// amostra [time, temperatura, umidade, pressão] por passo
+static void history_raw_step(http_stream_t *st, json_writer_t *w) {
+    uint32_t time_s;
+    int16_t values[HISTORY_METRICS];
+
+    if (!st->started) {
+        history_stream_open(w, "raw", UPDATE_INTERVAL_MS / 1000);
+        json_key(w, "samples");
+        json_array_begin(w);
+        st->started = true;
+        return;
+    }
+    if (st->pos < st->count && sample_store_next(&history_store, &st->cursor, &time_s, values)) {
+        st->pos++;
+        json_array_begin(w);
+        json_uint(w, time_s);
+        for (int m = 0; m < HISTORY_METRICS; m++) {
+            json_fixed(w, values[m], history_metric_decimals[m]);
+        }
+        json_array_end(w);
+        return;
+    }
+    json_array_end(w);
+    json_object_end(w);
+    st->done = true;
+}
+
+// Producer de /api/history: avança passo a passo até o buffer encher
+static size_t history_stream_fill(struct http_state *hs, char *buf, size_t cap) {
+    http_stream_t *st = &hs->stream;
+    st->json.buf = buf;
+    st->json.cap = cap;
+    st->json.len = 0;
+    while (!st->done) {
+        http_stream_t saved = *st;
+        if (st->source) {
+            history_tier_step(st, &st->json);
+        } else {
+            history_raw_step(st, &st->json);
+        }
+        if (st->json.overflow) {
+            *st = saved;  // O passo não coube: repete no próximo trecho
+            break;
+        }
+    }
+    return st->json.len;
+}
+
+static bool http_stream_begin(struct http_state *hs, const http_parser_t *req, http_producer_fn producer);
+
+// GET /api/history?res=raw|1m|1h: min/máx/média por intervalo (raw: amostras de 1 s).
+// O corpo passa de um buffer, então vai em trechos (chunked no HTTP/1.1).
+static bool http_get_history(struct http_state *hs, const http_parser_t *req) {
+    const char *res = query_find(req->query, "res");
+    http_stream_t *st = &hs->stream;
+
+    if (query_is(res, "1m")) {
+        st->source = 1;
+    } else if (query_is(res, "1h")) {
+        st->source = 2;
+    } else if (res && !query_is(res, "raw")) {
+        http_set_error(hs, HTTP_RESPONSE_400);
+        return true;
+    }
+
+    if (st->source) {
+        const HistoryTier *tier = &history_tiers[st->source - 1];
+        st->count = tier->total < tier->size ? tier->total : tier->size;
+        st->first = tier->total - st->count;
+    } else {
+        st->count = sample_store_count(&history_store);
+        sample_store_begin(&history_store, &st->cursor);
+    }
+
+    return http_stream_begin(hs, req, history_stream_fill);
+}
+
+// Primeiro trecho de uma resposta JSON gerada aos poucos pelo producer
+static bool http_stream_begin(struct http_state *hs, const http_parser_t *req, http_producer_fn producer) {
+    http_stream_t *st = &hs->stream;
+
+    hs->response = malloc(HTTP_RESPONSE_SIZE);
+    if (!hs->response) {
+        return false;
+    }
+    st->producer = producer;
+    st->chunked = req->http11;
+    if (!req->http11) {
+        hs->close_after = true;  // HTTP/1.0: o fim da conexão marca o fim do corpo
+    }
+
+    hs->len = snprintf(hs->header, sizeof(hs->header),
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/json\r\n"
+        "Cache-Control: no-store\r\n"
+        "%s"
+        "Connection: %s\r\n"
+        "\r\n",
+        st->chunked ? "Transfer-Encoding: chunked\r\n" : "",
+        hs->close_after ? "close" : "keep-alive");
+    hs->chunks[0] = (http_chunk_t){ hs->header, hs->len };
+    hs->chunk_count = 1;
+    http_stream_next(hs);
+    return true;
+}
+
+static const char *const log_field_names[] = {
+    "seq", "boot", "time",
+    "temperature", "temperature_min", "temperature_max",
+    "humidity", "humidity_min", "humidity_max",
+    "pressure", "pressure_min", "pressure_max",
+};
+
+// Passo de /api/log: um registro do log na flash por passo, até a seq
+// que era a próxima quando a exportação começou (st->count)
+static void log_stream_step(http_stream_t *st, json_writer_t *w) {
+    HistoryLogEntry e;
+    uint32_t seq;
+
+    if (!st->started) {
+        json_object_begin(w);
+        json_key(w, "boot");
+        json_uint(w, history_boot);
+        json_key(w, "fields");
+        json_array_begin(w);
+        for (size_t i = 0; i < sizeof(log_field_names) / sizeof(log_field_names[0]); i++) {
+            json_string(w, log_field_names[i]);
+        }
+        json_array_end(w);
+        json_key(w, "records");
+        json_array_begin(w);
+        st->started = true;
+        return;
+    }
+    flash_log_iter_t it = st->log;
+    if (flash_log_next(&history_log, &it, &seq, &e) && seq < st->count) {
+        st->log = it;
+        json_array_begin(w);
+        json_uint(w, seq);
+        json_uint(w, e.boot);
+        json_uint(w, e.time_s);
+        for (int m = 0; m < HISTORY_METRICS; m++) {
+            json_fixed(w, e.mean[m], history_metric_decimals[m]);
+            json_fixed(w, e.min[m], history_metric_decimals[m]);
+            json_fixed(w, e.max[m], history_metric_decimals[m]);
+        }
+        json_array_end(w);
+        return;
+    }
+    json_array_end(w);
+    json_key(w, "next");  // Para continuar com ?since=
+    json_uint(w, st->log.next_seq);
+    json_object_end(w);
+    st->done = true;
+}
+
+static size_t log_stream_fill(struct http_state *hs, char *buf, size_t cap) {
+    http_stream_t *st = &hs->stream;
+    st->json.buf = buf;
+    st->json.cap = cap;
+    st->json.len = 0;
+    while (!st->done) {
+        http_stream_t saved = *st;
+        log_stream_step(st, &st->json);
+        if (st->json.overflow) {
+            *st = saved;  // O passo não coube: repete no próximo trecho
+            break;
+        }
+    }
+    return st->json.len;
+}
+
+// GET /api/log?since=<seq>: exporta os buckets de 1 minuto guardados na flash
+static bool http_get_log(struct http_state *hs, const http_parser_t *req) {
+    http_stream_t *st = &hs->stream;
+    uint32_t from = 0;
+
+    if (!history_log_ready) {
+        http_set_error(hs, HTTP_RESPONSE_503);
+        return true;
+    }
+    query_param(req->query, "since", &from);
+    flash_log_seek(&history_log, &st->log, from);
+    st->count = history_log.next_seq;
+    return http_stream_begin(hs, req, log_stream_fill);
+}
+
+// Prepara a resposta em hs->chunks; false fecha a conexão (sem memória)
+typedef bool (*http_route_fn)(struct http_state *hs, const http_parser_t *req);
+
+static const struct {
+    http_method_t method;
+    const char *path;
+    http_route_fn handler;
+} http_routes[] = {
+    { HTTP_METHOD_GET,  "/api/data",   http_get_data },
+    { HTTP_METHOD_GET,  "/api/config", http_get_config },
+    { HTTP_METHOD_POST, "/api/config", http_post_config },
+    { HTTP_METHOD_GET,  "/api/stream", http_get_stream },
+    { HTTP_METHOD_GET,  "/api/stats",  http_get_stats },
+    { HTTP_METHOD_GET,  "/api/history", http_get_history },
+    { HTTP_METHOD_GET,  "/api/log",     http_get_log },
+};
+
+// Escolhe o handler pelo método e rota; GET fora da tabela serve os arquivos do painel
+static bool http_dispatch(struct http_state *hs, const http_parser_t *req) {
+    bool path_found = false;
+    for (size_t i = 0; i < sizeof(http_routes) / sizeof(http_routes[0]); i++) {
+        if (strcmp(req->path, http_routes[i].path) == 0) {
+            if (req->method == http_routes[i].method) {
+                return http_routes[i].handler(hs, req);
+            }
+            path_found = true;
+        }
+    }
+    if (req->method == HTTP_METHOD_GET && !path_found) {
+        return http_get_asset(hs, req);
+    }
+    http_set_error(hs, HTTP_RESPONSE_405);
+    return true;
+}
+
+// Resposta fixa de erro para cada falha do parser
+static const char *http_parse_error_response(http_parse_error_t error) {
+    switch (error) {
+        case HTTP_PARSE_URI_TOO_LONG:      return HTTP_RESPONSE_414;
+        case HTTP_PARSE_HEADERS_TOO_LARGE: return HTTP_RESPONSE_431;
+        case HTTP_PARSE_BODY_TOO_LARGE:    return HTTP_RESPONSE_413;
+        default:                           return HTTP_RESPONSE_400;
+    }
+}
+
+// Passa os segmentos recebidos ao parser e atende a requisição quando ela completa.
+// Com uma resposta em andamento, requisições em pipeline esperam em hs->rx.
+static err_t http_process(struct http_state *hs) {
+    if (hs->busy || !hs->rx) {
+        return ERR_OK;
+    }
+
+    // O parser guarda só os campos que usa; os bytes consumidos são liberados já
+    size_t used = 0;
+    for (struct pbuf *q = hs->rx; q; q = q->next) {
+        size_t n = http_parser_feed(&hs->parser, q->payload, q->len);
+        used += n;
+        if (n < q->len || http_parser_status(&hs->parser) != HTTP_PARSE_INCOMPLETE) {
+            break;
+        }
+    }
+    hs->rx = pbuf_free_header(hs->rx, used);
+    tcp_recved(hs->pcb, used);
+
+    switch (http_parser_status(&hs->parser)) {
+        case HTTP_PARSE_INCOMPLETE:
+            return ERR_OK;
+        case HTTP_PARSE_ERROR:
+            http_send_error(hs, http_parse_error_response(hs->parser.error));
+            return ERR_OK;
+        case HTTP_PARSE_DONE:
+            break;
+    }
+
+    hs->requests++;
+    if (!http_parser_keep_alive(&hs->parser) || hs->requests >= HTTP_MAX_REQUESTS_PER_CONN || hs->peer_closed) {
+        hs->close_after = true;
+    }
+
+    bool ok = http_dispatch(hs, &hs->parser);
+    http_parser_reset(&hs->parser);
+    if (!ok) {
+        return http_close(hs);
+    }
+    hs->busy = true;
+    http_send_more(hs->pcb, hs);
+    if (hs->sse) {
+        sse_push(hs);
+    }
+    return ERR_OK;
+}
+
 static err_t http_sent(void *arg, struct tcp_pcb *tpcb, u16_t len) {
     struct http_state *hs = (struct http_state *)arg;
     hs->sent += len;
-    if (hs->sent >= hs->len) {
-        tcp_close(tpcb);
-        free(hs);
+    hs->idle_ticks = 0;
+    if (hs->sse) {
+        http_send_more(tpcb, hs);
+        if (hs->sse_pending) {
+            sse_push(hs);
+        }
+        return ERR_OK;
     }
-    return ERR_OK;
+    if (hs->sent < hs->len || http_stream_next(hs)) {
+        http_send_more(tpcb, hs);
+        return ERR_OK;
+    }
+
+    // Resposta concluída
+    if (hs->close_after) {
+        return http_close(hs);
+    }
+    http_release_body(hs);
+    hs->chunk = hs->chunk_count = 0;
+    hs->offset = hs->len = hs->sent = 0;
+    hs->busy = false;
+    return http_process(hs);
 }
 
 static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    struct http_state *hs = (struct http_state *)arg;
+
     if (!p) {
-        tcp_close(tpcb);
+        // Cliente encerrou o envio: termina a resposta em andamento e fecha
+        hs->peer_closed = true;
+        if (!hs->busy || hs->sse) {
+            return http_close(hs);
+        }
+        hs->close_after = true;
         return ERR_OK;
     }
 
-    char *req = (char *)p->payload;
-    struct http_state *hs = malloc(sizeof(struct http_state));
-    if (!hs) {
-        pbuf_free(p);
-        tcp_close(tpcb);
-        return ERR_MEM;
-    }
-    hs->sent = 0;
-
-    if (strstr(req, "GET /api/data")) {
-        // Prepara dados JSON
-        char json[2048];
-        char history_temp[512] = "[";
-        char history_humid[512] = "[";
-        char history_press[512] = "[";
-        
-        // Monta arrays de histórico
-        for (int i = 0; i < history.count; i++) {
-            int idx = (history.index - history.count + i + MAX_DATA_POINTS) % MAX_DATA_POINTS;
-            char val[16];
-            
-            sprintf(val, "%.1f%s", history.temperature[idx], (i < history.count-1) ? "," : "");
-            strcat(history_temp, val);
-            
-            sprintf(val, "%.1f%s", history.humidity[idx], (i < history.count-1) ? "," : "");
-            strcat(history_humid, val);
-            
-            sprintf(val, "%.1f%s", history.pressure[idx], (i < history.count-1) ? "," : "");
-            strcat(history_press, val);
-        }
-        strcat(history_temp, "]");
-        strcat(history_humid, "]");
-        strcat(history_press, "]");
-        
-        // Monta resposta JSON completa
-        snprintf(json, sizeof(json),
-            "{"
-            "\"temperature\":%.2f,"
-            "\"humidity\":%.2f,"
-            "\"pressure\":%.2f,"
-            "\"altitude\":%.2f,"
-            "\"history\":{"
-            "\"temperature\":%s,"
-            "\"humidity\":%s,"
-            "\"pressure\":%s"
-            "}%s"
-            "}",
-            sensor_data.temperature + config.temp_offset,
-            sensor_data.humidity + config.humid_offset,
-            bmp_pressure + config.press_offset,
-            altitude,
-            history_temp,
-            history_humid,
-            history_press,
-            alarm_active ? ",\"alert\":\"Valores fora dos limites!\"" : ""
-        );
-        
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-            "HTTP/1.1 200 OK\r\n"
-            "Content-Type: application/json\r\n"
-            "Content-Length: %d\r\n"
-            "Connection: close\r\n"
-            "\r\n"
-            "%s",
-            (int)strlen(json), json);
-            
-    } else if (strstr(req, "GET /api/config")) {
-        // Retorna configurações atuais
-        char json[512];
-        snprintf(json, sizeof(json),
-            "{"
-            "\"temp_min\":%.1f,\"temp_max\":%.1f,"
-            "\"humid_min\":%.1f,\"humid_max\":%.1f,"
-            "\"press_min\":%.1f,\"press_max\":%.1f,"
-            "\"temp_offset\":%.1f,\"humid_offset\":%.1f,\"press_offset\":%.1f"
-            "}",
-            config.temp_min, config.temp_max,
-            config.humid_min, config.humid_max,
-            config.press_min, config.press_max,
-            config.temp_offset, config.humid_offset, config.press_offset
-        );
-        
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-            "HTTP/1.1 200 OK\r\n"
-            "Content-Type: application/json\r\n"
-            "Content-Length: %d\r\n"
-            "Connection: close\r\n"
-            "\r\n"
-            "%s",
-            (int)strlen(json), json);
-            
-    } else if (strstr(req, "POST /api/config")) {
-        // Processa nova configuração
-        char *body = strstr(req, "\r\n\r\n");
-        if (body) {
-            body += 4;
-            
-            // Parse JSON
-            sscanf(body, 
-                "{\"temp_min\":%f,\"temp_max\":%f,"
-                "\"humid_min\":%f,\"humid_max\":%f,"
-                "\"press_min\":%f,\"press_max\":%f,"
-                "\"temp_offset\":%f,\"humid_offset\":%f,\"press_offset\":%f",
-                &config.temp_min, &config.temp_max,
-                &config.humid_min, &config.humid_max,
-                &config.press_min, &config.press_max,
-                &config.temp_offset, &config.humid_offset, &config.press_offset
-            );
-            
-            buzzer_beep(50);  // Feedback sonoro
-        }
-        
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-            "HTTP/1.1 200 OK\r\n"
-            "Content-Type: text/plain\r\n"
-            "Content-Length: 2\r\n"
-            "Connection: close\r\n"
-            "\r\n"
-            "OK");
-            
+    hs->idle_ticks = 0;
+    if (hs->rx) {
+        pbuf_cat(hs->rx, p);
     } else {
-        // Página principal HTML
-        int html_len = strlen(HTML_HEADER) + strlen(HTML_BODY) + strlen(HTML_SCRIPT);
-        
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-            "HTTP/1.1 200 OK\r\n"
-            "Content-Type: text/html\r\n"
-            "Content-Length: %d\r\n"
-            "Connection: close\r\n"
-            "\r\n"
-            "%s%s%s",
-            html_len, HTML_HEADER, HTML_BODY, HTML_SCRIPT);
-    }
-
-    tcp_arg(tpcb, hs);
-    tcp_sent(tpcb, http_sent);
-    tcp_write(tpcb, hs->response, hs->len, TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
+        hs->rx = p;
+    }
+    return http_process(hs);
+}
+
+// Chamado pelo lwIP a cada HTTP_POLL_INTERVAL (unidades de 500 ms)
+static err_t http_poll(void *arg, struct tcp_pcb *tpcb) {
+    struct http_state *hs = (struct http_state *)arg;
+
+    // Fluxo SSE ocioso é normal; só conta tempo se há eventos sem ACK
+    if (hs->sse && hs->sent == hs->len) {
+        hs->idle_ticks = 0;
+        return ERR_OK;
+    }
 
-    pbuf_free(p);
+    // Sem requisições nem ACKs por tempo demais: libera o PCB
+    if (++hs->idle_ticks >= HTTP_IDLE_TIMEOUT_S * 2 / HTTP_POLL_INTERVAL) {
+        return http_close(hs);
+    }
+    if (hs->busy) {
+        http_send_more(tpcb, hs);  // Retoma escritas que falharam por falta de memória
+    }
     return ERR_OK;
 }
 
+// O PCB já foi liberado pelo lwIP: só limpa o estado
+static void http_err(void *arg, err_t err) {
+    struct http_state *hs = (struct http_state *)arg;
+    if (hs) {
+        sse_remove(hs);
+        if (hs->rx) {
+            pbuf_free(hs->rx);
+        }
+        http_release_body(hs);
+        http_pool_release(hs);
+    }
+}
+
 static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err) {
+    if (err != ERR_OK || !newpcb) {
+        return ERR_VAL;
+    }
+    struct http_state *hs = http_pool_acquire(newpcb);
+    if (!hs) {
+        // Pool cheio: 503 imediato direto da flash, sem estado nem leitura do pedido
+        if (tcp_write(newpcb, HTTP_RESPONSE_503, sizeof(HTTP_RESPONSE_503) - 1, 0) != ERR_OK ||
+            tcp_close(newpcb) != ERR_OK) {
+            tcp_abort(newpcb);
+            return ERR_ABRT;
+        }
+        return ERR_OK;
+    }
+
+    tcp_arg(newpcb, hs);
     tcp_recv(newpcb, http_recv);
+    tcp_sent(newpcb, http_sent);
+    tcp_poll(newpcb, http_poll, HTTP_POLL_INTERVAL);
+    tcp_err(newpcb, http_err);
     return ERR_OK;
 }
 
 void start_http_server(void) {
+    http_pool_init();
+
     struct tcp_pcb *pcb = tcp_new();
     if (!pcb) {
         printf("Erro ao criar PCB TCP\n");
@@ -985,4 +2520,4 @@ void start_http_server(void) {
     pcb = tcp_listen(pcb);
     tcp_accept(pcb, connection_callback);
     printf("Servidor HTTP iniciado na porta 80\n");
-}
\ No newline at end of file
+}
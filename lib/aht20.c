@@ -28,44 +28,100 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false;  // Falhou na calibração
 }
 
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
+// Instante a partir do qual a conversão em andamento deve estar pronta
+static absolute_time_t measure_ready_at;
+static bool measure_pending = false;
+
+// CRC-8 do AHT20: polinômio 0x31 (x^8 + x^5 + x^4 + 1), valor inicial 0xFF
+static uint8_t aht20_crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool aht20_trigger(i2c_inst_t *i2c) {
     uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
-    uint8_t buffer[6];
 
-    // Envia comando de medição
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false);
-    
-    // Aguarda até o sensor estar pronto
+    // Envia comando de medição e já retorna; o resultado é coletado depois
+    if (i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false) != 3) {
+        measure_pending = false;
+        return false;
+    }
+    measure_ready_at = make_timeout_time_ms(AHT20_MEASURE_TIME_MS);
+    measure_pending = true;
+    return true;
+}
+
+bool aht20_poll_ready(i2c_inst_t *i2c) {
+    if (!measure_pending) {
+        return false;
+    }
+
+    // Antes do tempo de conversão nem acessa o barramento
+    if (!time_reached(measure_ready_at)) {
+        return false;
+    }
+
     uint8_t status;
-    for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if (!(status & AHT20_STATUS_BUSY)) {
-            break;
-        }
-        sleep_ms(10);
+    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) != 1) {
+        return false;
     }
-    
-    // Se ainda estiver ocupado, falha na leitura
-    if (status & AHT20_STATUS_BUSY) {
+    return !(status & AHT20_STATUS_BUSY);
+}
+
+bool aht20_collect(i2c_inst_t *i2c, AHT20_Data *data) {
+    uint8_t buffer[7];
+
+    measure_pending = false;
+
+    // Lê status + 5 bytes de dados + CRC
+    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 7, false) != 7) {
         return false;
     }
 
-    // Lê os 6 bytes de dados
-    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) {
+    // Conversão ainda em andamento ou dados corrompidos no barramento
+    if (buffer[0] & AHT20_STATUS_BUSY) {
+        return false;
+    }
+    if (aht20_crc8(buffer, 6) != buffer[6]) {
         return false;
     }
 
-    // Processa os dados de umidade (20 bits)
+    // Processa os dados de umidade (20 bits): raw * 10000 / 2^20 = raw * 625 / 2^16
     uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+    data->humidity = (int32_t)((raw_humidity * 625u + 32768u) >> 16);
 
-    // Processa os dados de temperatura (20 bits)
+    // Processa os dados de temperatura (20 bits): raw * 20000 / 2^20 - 5000
     uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+    data->temperature = (int32_t)((raw_temp * 1250u + 32768u) >> 16) - 5000;
 
     return true;
 }
 
+bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
+    if (!aht20_trigger(i2c)) {
+        return false;
+    }
+
+    // Aguarda até o sensor estar pronto
+    sleep_ms(AHT20_MEASURE_TIME_MS);
+    for (int i = 0; i < 10; i++) {
+        if (aht20_poll_ready(i2c)) {
+            return aht20_collect(i2c, data);
+        }
+        sleep_ms(10);
+    }
+
+    // Se ainda estiver ocupado, falha na leitura
+    measure_pending = false;
+    return false;
+}
+
 void aht20_reset(i2c_inst_t *i2c) {
     uint8_t reset_cmd = AHT20_CMD_RESET;
     i2c_write_blocking(i2c, AHT20_I2C_ADDR, &reset_cmd, 1, false);
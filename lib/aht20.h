@@ -10,18 +10,30 @@
 #define AHT20_CMD_TRIGGER   0xAC
 #define AHT20_CMD_RESET     0xBA
 
-// Estrutura para armazenar os valores de temperatura e umidade
+// Tempo de conversão típico após o comando de medição (datasheet: >= 75 ms)
+#define AHT20_MEASURE_TIME_MS 80
+
+// Estrutura para armazenar os valores de temperatura e umidade (ponto fixo)
 typedef struct {
-    float temperature;
-    float humidity;
+    int32_t temperature;   // Centésimos de °C
+    int32_t humidity;      // Centésimos de %UR
 } AHT20_Data;
 
 // Inicializa o sensor AHT20
 bool aht20_init(i2c_inst_t *i2c);
 
-// Faz a leitura de temperatura e umidade do AHT20
+// Faz a leitura de temperatura e umidade do AHT20 (bloqueante, até ~100 ms)
 bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data);
 
+// API não bloqueante em duas fases: dispara a conversão e retorna imediatamente
+bool aht20_trigger(i2c_inst_t *i2c);
+
+// Retorna true quando a conversão disparada terminou (não espera)
+bool aht20_poll_ready(i2c_inst_t *i2c);
+
+// Lê o resultado da conversão, valida o CRC e só então atualiza *data
+bool aht20_collect(i2c_inst_t *i2c, AHT20_Data *data);
+
 // Reseta o sensor AHT20
 void aht20_reset(i2c_inst_t *i2c);
 
@@ -1,21 +1,102 @@
+#include "pico/stdlib.h"
 #include "bmp280.h"
 #include "hardware/i2c.h"
 
 #define ADDR _u(0x77)
 
+// Presets de configuração (datasheet, seção 3.8)
+const struct bmp280_config bmp280_preset_legacy = {
+    .mode = BMP280_MODE_NORMAL, .osrs_t = BMP280_OSRS_X1, .osrs_p = BMP280_OSRS_X4,
+    .filter = BMP280_FILTER_16, .standby = BMP280_STANDBY_500_MS
+};
+const struct bmp280_config bmp280_preset_weather = {
+    .mode = BMP280_MODE_FORCED, .osrs_t = BMP280_OSRS_X1, .osrs_p = BMP280_OSRS_X1,
+    .filter = BMP280_FILTER_OFF, .standby = BMP280_STANDBY_0_5_MS
+};
+const struct bmp280_config bmp280_preset_indoor = {
+    .mode = BMP280_MODE_NORMAL, .osrs_t = BMP280_OSRS_X2, .osrs_p = BMP280_OSRS_X16,
+    .filter = BMP280_FILTER_16, .standby = BMP280_STANDBY_0_5_MS
+};
+
+// Estado da configuração ativa, usado para saber quando há amostra nova
+static struct bmp280_config active_cfg;
+static bool forced_pending = false;
+static absolute_time_t next_sample_at;
+
+static const uint32_t standby_us[] = {
+    500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000
+};
+
+// Tempo máximo de uma medição em us (datasheet, seção 3.8.1)
+static uint32_t bmp280_measure_time_us(const struct bmp280_config *cfg) {
+    uint32_t t = 1250;
+    if (cfg->osrs_t != BMP280_OSRS_SKIP) {
+        t += 2300u << (cfg->osrs_t - 1);
+    }
+    if (cfg->osrs_p != BMP280_OSRS_SKIP) {
+        t += (2300u << (cfg->osrs_p - 1)) + 575;
+    }
+    return t;
+}
+
+static void bmp280_write_reg(i2c_inst_t *i2c, uint8_t reg, uint8_t value) {
+    uint8_t buf[2] = { reg, value };
+    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+}
+
 void bmp280_init(i2c_inst_t *i2c) {
+    bmp280_configure(i2c, &bmp280_preset_legacy);
+}
+
+void bmp280_configure(i2c_inst_t *i2c, const struct bmp280_config *cfg) {
+    active_cfg = *cfg;
+    forced_pending = false;
+
+    // Escritas em config podem ser ignoradas fora do modo sleep
+    bmp280_write_reg(i2c, REG_CTRL_MEAS, BMP280_MODE_SLEEP);
+    bmp280_write_reg(i2c, REG_CONFIG, (cfg->standby << 5) | (cfg->filter << 2));
+
+    // No modo forçado o sensor fica em sleep até bmp280_trigger_forced
+    uint8_t mode = (cfg->mode == BMP280_MODE_NORMAL) ? BMP280_MODE_NORMAL : BMP280_MODE_SLEEP;
+    bmp280_write_reg(i2c, REG_CTRL_MEAS, (cfg->osrs_t << 5) | (cfg->osrs_p << 2) | mode);
+    next_sample_at = make_timeout_time_us(bmp280_measure_time_us(cfg));
+}
+
+bool bmp280_trigger_forced(i2c_inst_t *i2c) {
+    if (active_cfg.mode != BMP280_MODE_FORCED) {
+        return false;
+    }
+    bmp280_write_reg(i2c, REG_CTRL_MEAS, (active_cfg.osrs_t << 5) | (active_cfg.osrs_p << 2) | BMP280_MODE_FORCED);
+    forced_pending = true;
+    next_sample_at = make_timeout_time_us(bmp280_measure_time_us(&active_cfg));
+    return true;
+}
+
+bool bmp280_data_ready(i2c_inst_t *i2c) {
+    // Nenhuma medição nova desde a última leitura
+    if (active_cfg.mode == BMP280_MODE_FORCED && !forced_pending) {
+        return false;
+    }
+    if (!time_reached(next_sample_at)) {
+        return false;
+    }
+
+    // status (0xF3) e ctrl_meas (0xF4) são lidos numa única transação
     uint8_t buf[2];
-    const uint8_t reg_config_val = ((0x04 << 5) | (0x05 << 2)) & 0xFC;
-    buf[0] = REG_CONFIG;
-    buf[1] = reg_config_val;
-   
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+    uint8_t reg = REG_STATUS;
+    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
+    if (i2c_read_blocking(i2c, ADDR, buf, 2, false) != 2) {
+        return false;
+    }
+    if (buf[0] & (BMP280_STATUS_MEASURING | BMP280_STATUS_IM_UPDATE)) {
+        return false;
+    }
 
-    const uint8_t reg_ctrl_meas_val = (0x01 << 5) | (0x03 << 2) | (0x03);
-    buf[0] = REG_CTRL_MEAS;
-    buf[1] = reg_ctrl_meas_val;
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
- //   printf("Ctrl_meas register value: %x\n", reg_ctrl_meas_val);
+    // Ao fim de uma medição forçada o sensor volta sozinho para sleep
+    if (active_cfg.mode == BMP280_MODE_FORCED && (buf[1] & 0x03) != BMP280_MODE_SLEEP) {
+        return false;
+    }
+    return true;
 }
 
 void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
@@ -27,7 +108,11 @@ void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
     *pressure = (buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4);
     *temp = (buf[3] << 12) | (buf[4] << 4) | (buf[5] >> 4);
 
-
+    // Marca a amostra como consumida
+    forced_pending = false;
+    if (active_cfg.mode == BMP280_MODE_NORMAL) {
+        next_sample_at = make_timeout_time_us(standby_us[active_cfg.standby] + bmp280_measure_time_us(&active_cfg));
+    }
 }
 
 void bmp280_reset(i2c_inst_t *i2c) {
@@ -45,18 +130,29 @@ int32_t bmp280_convert(int32_t temp, struct bmp280_calib_param* params) {
     return var1 + var2;
 }
 
-int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params) {
-    // Utiliza os parâmetros de calibração do BMP280 para compensar o valor de temperatura lido de seus registradores
-    int32_t t_fine = bmp280_convert(temp, params);
-    return (t_fine * 5 + 128) >> 8;
+#ifdef BMP280_USE_64BIT_COMPENSATION
+// Compensação de pressão em 64 bits do datasheet; resultado em Pa no formato Q24.8
+static uint32_t bmp280_pressure_q8(int32_t pressure, int32_t t_fine, const struct bmp280_calib_param* params) {
+    int64_t var1, var2, p;
+    var1 = ((int64_t)t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t)params->dig_p6;
+    var2 = var2 + var1 * (int64_t)params->dig_p5 * 131072;
+    var2 = var2 + (int64_t)params->dig_p4 * 34359738368LL;
+    var1 = ((var1 * var1 * (int64_t)params->dig_p3) >> 8) + var1 * (int64_t)params->dig_p2 * 4096;
+    var1 = (((((int64_t)1) << 47) + var1) * ((int64_t)params->dig_p1)) >> 33;
+    if (var1 == 0) {
+        return 0;  // avoid exception caused by division by zero
+    }
+    p = 1048576 - pressure;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t)params->dig_p9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t)params->dig_p8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (((int64_t)params->dig_p7) << 4);
+    return (uint32_t)p;
 }
-
-
-int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params) {
-    // Utiliza os parâmetros de calibração do BMP280 para compensar o valor de pressão lido de seus registradores
-
-    int32_t t_fine = bmp280_convert(temp, params);
-
+#else
+// Compensação de pressão em 32 bits do datasheet; resultado em Pa
+static uint32_t bmp280_pressure_pa(int32_t pressure, int32_t t_fine, const struct bmp280_calib_param* params) {
     int32_t var1, var2;
     uint32_t converted = 0.0;
     var1 = (((int32_t)t_fine) >> 1) - (int32_t)64000;
@@ -79,6 +175,32 @@ int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_ca
     converted = (uint32_t)((int32_t)converted + ((var1 + var2 + params->dig_p7) >> 4));
     return converted;
 }
+#endif
+
+// Compensa temperatura e pressão de uma amostra calculando t_fine uma única vez
+void bmp280_compensate(int32_t raw_temp, int32_t raw_pressure, const struct bmp280_calib_param* params, struct bmp280_reading* out) {
+    int32_t t_fine = bmp280_convert(raw_temp, (struct bmp280_calib_param*)params);
+    out->temperature = (t_fine * 5 + 128) >> 8;
+#ifdef BMP280_USE_64BIT_COMPENSATION
+    out->pressure = (bmp280_pressure_q8(raw_pressure, t_fine, params) + 128) >> 8;
+#else
+    out->pressure = bmp280_pressure_pa(raw_pressure, t_fine, params);
+#endif
+}
+
+int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params) {
+    // Utiliza os parâmetros de calibração do BMP280 para compensar o valor de temperatura lido de seus registradores
+    int32_t t_fine = bmp280_convert(temp, params);
+    return (t_fine * 5 + 128) >> 8;
+}
+
+
+int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params) {
+    // Utiliza os parâmetros de calibração do BMP280 para compensar o valor de pressão lido de seus registradores
+    struct bmp280_reading reading;
+    bmp280_compensate(temp, pressure, params, &reading);
+    return reading.pressure;
+}
 
 void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params) {
     uint8_t buf[NUM_CALIB_PARAMS] = { 0 };
@@ -8,8 +8,13 @@
 
 #define REG_CONFIG _u(0xF5)
 #define REG_CTRL_MEAS _u(0xF4)
+#define REG_STATUS _u(0xF3)
 #define REG_RESET _u(0xE0)
 
+// Bits do registrador de status
+#define BMP280_STATUS_MEASURING _u(0x08)
+#define BMP280_STATUS_IM_UPDATE _u(0x01)
+
 #define REG_TEMP_XLSB _u(0xFC)
 #define REG_TEMP_LSB _u(0xFB)
 #define REG_TEMP_MSB _u(0xFA)
@@ -61,8 +66,69 @@ struct bmp280_calib_param {
     int16_t dig_p9;
 };
 
+// Modos de operação (campo mode de ctrl_meas)
+typedef enum {
+    BMP280_MODE_SLEEP  = 0x00,
+    BMP280_MODE_FORCED = 0x01,
+    BMP280_MODE_NORMAL = 0x03
+} bmp280_mode_t;
+
+// Oversampling de temperatura e pressão (campos osrs_t e osrs_p)
+typedef enum {
+    BMP280_OSRS_SKIP = 0x00,
+    BMP280_OSRS_X1   = 0x01,
+    BMP280_OSRS_X2   = 0x02,
+    BMP280_OSRS_X4   = 0x03,
+    BMP280_OSRS_X8   = 0x04,
+    BMP280_OSRS_X16  = 0x05
+} bmp280_osrs_t;
+
+// Coeficiente do filtro IIR (campo filter de config)
+typedef enum {
+    BMP280_FILTER_OFF = 0x00,
+    BMP280_FILTER_2   = 0x01,
+    BMP280_FILTER_4   = 0x02,
+    BMP280_FILTER_8   = 0x03,
+    BMP280_FILTER_16  = 0x04
+} bmp280_filter_t;
+
+// Tempo de standby entre medições no modo normal (campo t_sb de config)
+typedef enum {
+    BMP280_STANDBY_0_5_MS  = 0x00,
+    BMP280_STANDBY_62_5_MS = 0x01,
+    BMP280_STANDBY_125_MS  = 0x02,
+    BMP280_STANDBY_250_MS  = 0x03,
+    BMP280_STANDBY_500_MS  = 0x04,
+    BMP280_STANDBY_1000_MS = 0x05,
+    BMP280_STANDBY_2000_MS = 0x06,
+    BMP280_STANDBY_4000_MS = 0x07
+} bmp280_standby_t;
+
+struct bmp280_config {
+    bmp280_mode_t mode;
+    bmp280_osrs_t osrs_t;
+    bmp280_osrs_t osrs_p;
+    bmp280_filter_t filter;
+    bmp280_standby_t standby;
+};
+
+// Presets (tabela 15 do datasheet)
+extern const struct bmp280_config bmp280_preset_legacy;   // valores antigos de bmp280_init
+extern const struct bmp280_config bmp280_preset_weather;  // forçado, x1/x1, sem filtro
+extern const struct bmp280_config bmp280_preset_indoor;   // normal, x2/x16, IIR 16
+
+// Resultado compensado: temperatura em centésimos de °C e pressão em Pa
+struct bmp280_reading {
+    int32_t temperature;
+    uint32_t pressure;
+};
+
 //void bmp280_init(void);
 void bmp280_init(i2c_inst_t *i2c);
+void bmp280_configure(i2c_inst_t *i2c, const struct bmp280_config *cfg);
+bool bmp280_trigger_forced(i2c_inst_t *i2c);
+bool bmp280_data_ready(i2c_inst_t *i2c);
+void bmp280_compensate(int32_t raw_temp, int32_t raw_pressure, const struct bmp280_calib_param *params, struct bmp280_reading *out);
 void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure);
 void bmp280_reset(i2c_inst_t *i2c);
 int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params);
@@ -0,0 +1,164 @@
+#include "derived.h"
+#include "derived_tables.h"
+
+// Constantes reais em ponto fixo (o compilador resolve; nada de float em execução)
+#define Q16(x) ((int64_t)((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define Q30(x) ((int64_t)((x) * 1073741824.0 + 0.5))
+#define Q32(x) ((int64_t)((x) * 4294967296.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+#define BARO_EXPONENT Q30(0.1903)        // 1/5,255 (atmosfera padrão)
+#define BARO_HEIGHT_CM 4433000           // 44330 m
+#define MAGNUS_B Q16(17.62)
+#define MAGNUS_C 24312                   // 243,12 °C
+#define ABS_HUMIDITY_K 13244700          // 216,7 g·K/J × 6,112 hPa, em centésimos
+#define LN2 Q30(0.69314718056)
+#define LOG2E Q30(1.44269504089)
+
+#define TEMP_MIN (-4000)
+#define TEMP_MAX 8500
+#define HUMID_MIN 1                      // 0 %UR levaria o orvalho a -infinito
+#define HUMID_MAX 10000
+
+static int32_t clamp(int32_t v, int32_t lo, int32_t hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Interpolação linear entre table[i] e table[i + 1], rem em bits fracionários
+static uint32_t lerp(const uint32_t *table, uint32_t i, uint32_t rem, int bits) {
+    return table[i] + (uint32_t)(((uint64_t)(table[i + 1] - table[i]) * rem) >> bits);
+}
+
+// log2(x) em Q26, x inteiro de 1 a 2^30
+static int32_t log2_q26(uint32_t x) {
+    int n = 31 - __builtin_clz(x);
+    uint32_t m = x << (31 - n);          // Mantissa com o 1 implícito no bit 31
+    uint32_t frac = lerp(log2_table, (m >> (31 - DERIVED_TABLE_BITS)) & ((1u << DERIVED_TABLE_BITS) - 1),
+                         m & ((1u << (31 - DERIVED_TABLE_BITS)) - 1), 31 - DERIVED_TABLE_BITS);
+    return (n << 26) + (int32_t)((frac + 8) >> 4);
+}
+
+// 2^(y / 2^26) com frac_bits bits fracionários; o resultado precisa caber em 32 bits
+static uint32_t exp2_q26(int32_t y, int frac_bits) {
+    int32_t k = y >> 26;                 // Parte inteira (piso)
+    uint32_t f = (uint32_t)y & ((1u << 26) - 1);
+    uint32_t v = lerp(exp2_table, f >> (26 - DERIVED_TABLE_BITS),
+                      f & ((1u << (26 - DERIVED_TABLE_BITS)) - 1), 26 - DERIVED_TABLE_BITS);
+    int shift = 30 - frac_bits - k;
+
+    if (shift >= 32) {
+        return 0;
+    }
+    if (shift <= 0) {
+        return v << -shift;
+    }
+    return (v + (1u << (shift - 1))) >> shift;
+}
+
+// Divisão de 64 bits arredondada ao mais próximo (d > 0)
+static int64_t div_round(int64_t n, int64_t d) {
+    return (n < 0 ? n - d / 2 : n + d / 2) / d;
+}
+
+int32_t derived_altitude(int32_t pressure, int32_t qnh) {
+    if (pressure <= 0 || qnh <= 0) {
+        return 0;
+    }
+    // (p/qnh)^0,1903 = 2^(0,1903 * (log2 p - log2 qnh)), sem divisão
+    int32_t y = (int32_t)(((int64_t)(log2_q26(pressure) - log2_q26(qnh)) * BARO_EXPONENT) >> 30);
+    int64_t ratio = exp2_q26(y, 30);
+    return (int32_t)((((1LL << 30) - ratio) * BARO_HEIGHT_CM + (1LL << 29)) >> 30);
+}
+
+// γ = ln(UR/100) + b·T/(c+T) em Q16; e = 6,112 hPa · e^γ é a pressão de vapor
+static int32_t magnus_gamma(int32_t temperature, int32_t humidity) {
+    int32_t t = clamp(temperature, TEMP_MIN, TEMP_MAX);
+    int32_t rh = clamp(humidity, HUMID_MIN, HUMID_MAX);
+    int32_t ln_rh = (int32_t)(((int64_t)(log2_q26(rh) - log2_q26(HUMID_MAX)) * LN2) >> 40);
+    return ln_rh + (int32_t)(MAGNUS_B * t / (MAGNUS_C + t));
+}
+
+static int32_t dew_point_from_gamma(int32_t gamma) {
+    return (int32_t)div_round((int64_t)MAGNUS_C * gamma, MAGNUS_B - gamma);
+}
+
+// AH = 216,7 · e / T(K)
+static int32_t abs_humidity_from_gamma(int32_t temperature, int32_t gamma) {
+    int32_t t = clamp(temperature, TEMP_MIN, TEMP_MAX);
+    int64_t e = exp2_q26((int32_t)(((int64_t)gamma * LOG2E) >> 20), 20);
+    return (int32_t)div_round(e * ABS_HUMIDITY_K, (int64_t)(t + 27315) << 20);
+}
+
+int32_t derived_dew_point(int32_t temperature, int32_t humidity) {
+    return dew_point_from_gamma(magnus_gamma(temperature, humidity));
+}
+
+int32_t derived_abs_humidity(int32_t temperature, int32_t humidity) {
+    return abs_humidity_from_gamma(temperature, magnus_gamma(temperature, humidity));
+}
+
+static int64_t mul_q16(int64_t a, int64_t b) {
+    return (a * b) >> 16;
+}
+
+// Coeficiente em Q32 vezes valor em Q16 -> Q16
+static int64_t coef_q32(int64_t c, int64_t v) {
+    return (c * v) >> 32;
+}
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    for (; bit; bit >>= 2) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return (uint32_t)root;
+}
+
+int32_t derived_heat_index(int32_t temperature, int32_t humidity) {
+    int32_t t = clamp(temperature, TEMP_MIN, TEMP_MAX);
+    int32_t rh = clamp(humidity, 0, HUMID_MAX);
+    int64_t f = div_round(((int64_t)t * 9 + 16000) << 16, 500);  // °F em Q16
+    int64_t r = ((int64_t)rh << 16) / 100;                       // % em Q16
+    int64_t hi = (f + Q16(61.0) + mul_q16(f - Q16(68.0), Q16(1.2)) + mul_q16(r, Q16(0.094))) / 2;
+
+    if ((hi + f) / 2 >= Q16(80.0)) {
+        int64_t f2 = mul_q16(f, f);
+        int64_t r2 = mul_q16(r, r);
+        hi = Q16(-42.379)
+            + coef_q32(Q32(2.04901523), f)
+            + coef_q32(Q32(10.14333127), r)
+            - coef_q32(Q32(0.22475541), mul_q16(f, r))
+            - coef_q32(Q32(6.83783e-3), f2)
+            - coef_q32(Q32(5.481717e-2), r2)
+            + coef_q32(Q32(1.22874e-3), mul_q16(f2, r))
+            + coef_q32(Q32(8.5282e-4), mul_q16(f, r2))
+            - coef_q32(Q32(1.99e-6), mul_q16(f2, r2));
+
+        if (r < Q16(13.0) && f >= Q16(80.0) && f <= Q16(112.0)) {
+            int64_t d = f > Q16(95.0) ? f - Q16(95.0) : Q16(95.0) - f;
+            uint32_t s = isqrt64((uint64_t)((Q16(17.0) - d) / 17) << 16);
+            hi -= mul_q16((Q16(13.0) - r) / 4, s);
+        } else if (r > Q16(85.0) && f >= Q16(80.0) && f <= Q16(87.0)) {
+            hi += mul_q16((r - Q16(85.0)) / 10, (Q16(87.0) - f) / 5);
+        }
+    }
+    return (int32_t)div_round((hi - Q16(32.0)) * 500, 9LL << 16);
+}
+
+void derived_compute(measurement_t *m, int32_t qnh) {
+    int32_t gamma = magnus_gamma(m->temperature, m->humidity);
+
+    m->altitude = derived_altitude(m->pressure, qnh);
+    m->dew_point = dew_point_from_gamma(gamma);
+    m->abs_humidity = abs_humidity_from_gamma(m->temperature, gamma);
+    m->heat_index = derived_heat_index(m->temperature, m->humidity);
+}
@@ -0,0 +1,31 @@
+#ifndef DERIVED_H
+#define DERIVED_H
+
+#include <stdint.h>
+#include "measurement.h"
+
+#define DERIVED_QNH_DEFAULT 101325       // Atmosfera padrão (Pa)
+
+// Grandezas derivadas em ponto fixo, sem libm nem ponto flutuante: log2 e
+// exp2 por tabela (tools/gen_derived_tables.py) e polinômios com
+// coeficientes inteiros. Entradas nas unidades de measurement_t; temperatura
+// e umidade são limitadas à faixa do AHT20 (-40 a 85 °C, 0 a 100 %UR).
+
+// Altitude (cm) pela fórmula barométrica, com a pressão ao nível do mar
+// (QNH, Pa) informada. Erro < 0,1 m de 300 a 1100 hPa.
+int32_t derived_altitude(int32_t pressure, int32_t qnh);
+
+// Ponto de orvalho (centésimos de °C) pela fórmula de Magnus (Sonntag 1990)
+int32_t derived_dew_point(int32_t temperature, int32_t humidity);
+
+// Umidade absoluta (centésimos de g/m³), com a pressão de vapor de Magnus
+int32_t derived_abs_humidity(int32_t temperature, int32_t humidity);
+
+// Índice de calor (centésimos de °C), regressão de Rothfusz com os ajustes
+// do NWS; abaixo de ~27 °C vale a fórmula simples de Steadman
+int32_t derived_heat_index(int32_t temperature, int32_t humidity);
+
+// Preenche altitude e derivadas de m a partir de temperatura, umidade e pressão
+void derived_compute(measurement_t *m, int32_t qnh);
+
+#endif
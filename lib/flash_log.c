@@ -0,0 +1,273 @@
+#include <stddef.h>
+#include <string.h>
+#include "flash_log.h"
+
+#define FLASH_LOG_MAGIC 0x474F4C57u           // "WLOG"
+#define PAGES_PER_SECTOR (FLASH_LOG_SECTOR_SIZE / FLASH_LOG_PAGE_SIZE)
+#define RECORDS_PER_PAGE (FLASH_LOG_PAGE_SIZE / sizeof(flash_log_record_t))
+#define EMPTY_SEQ 0xFFFFFFFFu                 // Slot apagado
+
+// Cabeçalho na página 0 de cada setor
+typedef struct {
+    uint32_t magic;
+    uint32_t first_seq;
+    uint32_t crc;
+} sector_header_t;
+
+static uint32_t crc32(const void *data, size_t len) {
+    const uint8_t *p = data;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t record_crc(const flash_log_record_t *rec) {
+    return crc32(rec, offsetof(flash_log_record_t, crc));
+}
+
+static uint32_t page_offset(uint16_t sector, uint16_t page) {
+    return (uint32_t)sector * FLASH_LOG_SECTOR_SIZE + (uint32_t)page * FLASH_LOG_PAGE_SIZE;
+}
+
+static bool page_erased(const flash_log_t *log, uint16_t sector, uint16_t page) {
+    const uint8_t *p = log->flash->base + page_offset(sector, page);
+    for (int i = 0; i < FLASH_LOG_PAGE_SIZE; i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Lê um registro da flash, ou do buffer em RAM se for a página em escrita
+static void read_record(const flash_log_t *log, uint16_t sector, uint16_t page, uint16_t slot,
+                        flash_log_record_t *rec) {
+    const uint8_t *src = sector == log->head && page == log->page
+        ? log->buf
+        : log->flash->base + page_offset(sector, page);
+    memcpy(rec, src + slot * sizeof(*rec), sizeof(*rec));
+}
+
+static uint16_t next_sector(const flash_log_t *log, uint16_t sector) {
+    return (sector + 1) % log->flash->sector_count;
+}
+
+static bool erase_sector(flash_log_t *log, uint16_t sector) {
+    log->first_seq[sector] = 0;  // Invalida antes: um leitor nunca vê o setor meio apagado
+    if (!log->flash->erase(log->flash->ctx, page_offset(sector, 0))) {
+        return false;
+    }
+    log->sectors_erased++;
+    return true;
+}
+
+// Passa a escrever no setor seguinte (apaga se ainda não foi) e grava o cabeçalho
+static bool open_next_sector(flash_log_t *log) {
+    uint16_t sector = next_sector(log, log->head);
+    uint8_t page[FLASH_LOG_PAGE_SIZE];
+    sector_header_t h = { FLASH_LOG_MAGIC, log->next_seq, 0 };
+
+    if (!log->next_erased && !erase_sector(log, sector)) {
+        return false;
+    }
+    log->next_erased = false;
+
+    h.crc = crc32(&h, offsetof(sector_header_t, crc));
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, &h, sizeof(h));
+    if (!log->flash->program(log->flash->ctx, page_offset(sector, 0), page)) {
+        return false;
+    }
+    log->pages_written++;
+    log->first_seq[sector] = h.first_seq;
+    log->head = sector;
+    log->page = 1;
+    log->slot = 0;
+    return true;
+}
+
+// Grava buf na página atual; com a página cheia, avança para a próxima.
+// Regravar uma página parcial com mais registros é seguro: os bytes já
+// gravados se repetem e a flash NOR só precisa zerar bits dos slots novos.
+static bool program_page(flash_log_t *log) {
+    if (!log->flash->program(log->flash->ctx, page_offset(log->head, log->page), log->buf)) {
+        return false;
+    }
+    log->pages_written++;
+    log->dirty = false;
+    if (log->slot == RECORDS_PER_PAGE) {
+        log->page++;
+        log->slot = 0;
+        memset(log->buf, 0xFF, sizeof(log->buf));
+    }
+    return true;
+}
+
+bool flash_log_open(flash_log_t *log, const flash_log_backend_t *flash) {
+    int newest = -1;
+
+    memset(log, 0, sizeof(*log));
+    memset(log->buf, 0xFF, sizeof(log->buf));
+    log->flash = flash;
+    log->next_seq = 1;
+    if (flash->sector_count < 2 || flash->sector_count > FLASH_LOG_MAX_SECTORS) {
+        return false;
+    }
+
+    for (uint16_t s = 0; s < flash->sector_count; s++) {
+        sector_header_t h;
+        memcpy(&h, flash->base + page_offset(s, 0), sizeof(h));
+        if (h.magic != FLASH_LOG_MAGIC || h.first_seq == 0 || h.first_seq == EMPTY_SEQ ||
+            h.crc != crc32(&h, offsetof(sector_header_t, crc))) {
+            continue;
+        }
+        log->first_seq[s] = h.first_seq;
+        if (newest < 0 || h.first_seq > log->first_seq[newest]) {
+            newest = s;
+        }
+    }
+
+    if (newest < 0) {
+        // Região nova ou corrompida: começa pelo setor 0
+        log->head = flash->sector_count - 1;
+        log->page = PAGES_PER_SECTOR;
+        return open_next_sector(log);
+    }
+
+    // Só o setor mais novo é percorrido: acha a última seq e a primeira página
+    // livre. Uma página parcial (reset no meio) fica para trás, porque um
+    // registro interrompido não pode ser regravado.
+    log->head = newest;
+    log->next_seq = log->first_seq[newest];
+    log->page = 1;
+    for (uint16_t p = 1; p < PAGES_PER_SECTOR; p++) {
+        if (page_erased(log, newest, p)) {
+            continue;
+        }
+        log->page = p + 1;
+        for (uint16_t i = 0; i < RECORDS_PER_PAGE; i++) {
+            flash_log_record_t rec;
+            memcpy(&rec, flash->base + page_offset(newest, p) + i * sizeof(rec), sizeof(rec));
+            if (rec.seq != EMPTY_SEQ && rec.seq >= log->next_seq && rec.crc == record_crc(&rec)) {
+                log->next_seq = rec.seq + 1;
+            }
+        }
+    }
+    return true;
+}
+
+bool flash_log_append(flash_log_t *log, const void *payload) {
+    flash_log_record_t rec;
+
+    if (log->slot == RECORDS_PER_PAGE && !program_page(log)) {
+        return false;  // Página anterior ainda não foi gravada pelo service
+    }
+    if (log->page == PAGES_PER_SECTOR && !open_next_sector(log)) {
+        return false;
+    }
+
+    rec.seq = log->next_seq;
+    memcpy(rec.payload, payload, sizeof(rec.payload));
+    rec.crc = record_crc(&rec);
+    memcpy(log->buf + log->slot * sizeof(rec), &rec, sizeof(rec));
+    log->slot++;
+    log->dirty = true;
+    log->next_seq++;
+    return true;
+}
+
+void flash_log_service(flash_log_t *log, bool idle) {
+    if (!idle) {
+        return;
+    }
+    if (log->slot == RECORDS_PER_PAGE) {
+        program_page(log);
+        return;
+    }
+    // Apaga o próximo setor quando o atual está na última página: a pausa longa
+    // cai num momento ocioso em vez de no meio de um append
+    if (!log->next_erased && log->page >= PAGES_PER_SECTOR - 1) {
+        log->next_erased = erase_sector(log, next_sector(log, log->head));
+    }
+}
+
+bool flash_log_flush(flash_log_t *log) {
+    return !log->dirty || program_page(log);
+}
+
+uint32_t flash_log_oldest(const flash_log_t *log) {
+    for (uint16_t s = next_sector(log, log->head); ; s = next_sector(log, s)) {
+        if (log->first_seq[s] || s == log->head) {
+            return log->first_seq[s];
+        }
+    }
+}
+
+void flash_log_seek(const flash_log_t *log, flash_log_iter_t *it, uint32_t seq) {
+    int found = -1;
+
+    // Do mais antigo ao mais novo: fica o último setor que começa em seq ou antes
+    for (uint16_t s = next_sector(log, log->head); ; s = next_sector(log, s)) {
+        if (log->first_seq[s] && (found < 0 || log->first_seq[s] <= seq)) {
+            found = s;
+        }
+        if (s == log->head) {
+            break;
+        }
+    }
+    it->sector = found < 0 ? log->head : found;
+    it->page = 1;
+    it->slot = 0;
+    it->sector_first = log->first_seq[it->sector];
+    it->next_seq = seq;
+}
+
+bool flash_log_next(const flash_log_t *log, flash_log_iter_t *it, uint32_t *seq, void *payload) {
+    for (;;) {
+        flash_log_record_t rec;
+
+        if (log->first_seq[it->sector] != it->sector_first) {
+            flash_log_seek(log, it, it->next_seq);  // Setor reciclado desde a última leitura
+        }
+        bool at_head = it->sector == log->head;
+        if (at_head && (it->page > log->page || (it->page == log->page && it->slot >= log->slot))) {
+            return false;
+        }
+        if (it->page == PAGES_PER_SECTOR) {
+            uint16_t s = next_sector(log, it->sector);
+            if (at_head || !log->first_seq[s]) {
+                return false;
+            }
+            it->sector = s;
+            it->page = 1;
+            it->slot = 0;
+            it->sector_first = log->first_seq[s];
+            continue;
+        }
+
+        read_record(log, it->sector, it->page, it->slot, &rec);
+        if (++it->slot == RECORDS_PER_PAGE) {
+            it->slot = 0;
+            it->page++;
+        }
+        if (rec.seq == EMPTY_SEQ) {
+            if (it->slot) {
+                it->slot = 0;  // Resto de uma página parcial deixada por um reset
+                it->page++;
+            }
+            continue;
+        }
+        if (rec.crc != record_crc(&rec) || rec.seq < it->next_seq) {
+            continue;
+        }
+        *seq = rec.seq;
+        memcpy(payload, rec.payload, sizeof(rec.payload));
+        it->next_seq = rec.seq + 1;
+        return true;
+    }
+}
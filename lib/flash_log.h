@@ -0,0 +1,81 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLASH_LOG_SECTOR_SIZE 4096
+#define FLASH_LOG_PAGE_SIZE 256
+#define FLASH_LOG_MAX_SECTORS 64
+#define FLASH_LOG_PAYLOAD 24
+
+// Registro de tamanho fixo; 8 por página. seq começa em 1 e nunca repete.
+typedef struct {
+    uint32_t seq;
+    uint8_t payload[FLASH_LOG_PAYLOAD];
+    uint32_t crc;                            // CRC-32 de seq + payload
+} flash_log_record_t;
+
+// Acesso à região reservada da flash. A leitura é direta pelo ponteiro (XIP na
+// placa, um array em RAM num emulador); offsets são relativos ao início da região.
+typedef struct {
+    const uint8_t *base;
+    uint16_t sector_count;
+    bool (*erase)(void *ctx, uint32_t offset);                       // Um setor
+    bool (*program)(void *ctx, uint32_t offset, const uint8_t *page); // Uma página
+    void *ctx;
+} flash_log_backend_t;
+
+// Log circular de setores: a página 0 de cada setor tem um cabeçalho com a
+// seq do primeiro registro; as demais guardam registros. Os registros se
+// acumulam em RAM e cada página é gravada de uma vez; o setor seguinte é
+// apagado antes de ser preciso, quando o chamador indica que está ocioso.
+typedef struct {
+    const flash_log_backend_t *flash;
+    uint32_t first_seq[FLASH_LOG_MAX_SECTORS]; // Por setor; 0: vazio/inválido
+    uint16_t head;                           // Setor em escrita
+    uint16_t page;                           // Página em escrita no setor
+    uint16_t slot;                           // Próximo registro em buf
+    bool dirty;                              // buf tem registros ainda não gravados
+    bool next_erased;                        // O setor depois de head já está apagado
+    uint32_t next_seq;
+    uint32_t pages_written;
+    uint32_t sectors_erased;
+    uint8_t buf[FLASH_LOG_PAGE_SIZE];        // Página em escrita
+} flash_log_t;
+
+// Posição de leitura; sobrevive a novos registros e à reciclagem de setores
+typedef struct {
+    uint16_t sector;
+    uint16_t page;
+    uint16_t slot;
+    uint32_t sector_first;                   // first_seq do setor ao entrar nele
+    uint32_t next_seq;                       // Menor seq ainda não entregue
+} flash_log_iter_t;
+
+// Recupera o estado lendo só os cabeçalhos e o setor mais novo; região sem
+// nenhum cabeçalho válido é iniciada do zero. false: falha da flash.
+bool flash_log_open(flash_log_t *log, const flash_log_backend_t *flash);
+
+// Acrescenta um registro (payload de FLASH_LOG_PAYLOAD bytes). Só grava na hora
+// se a página anterior ainda está pendente ou se o setor acabou.
+bool flash_log_append(flash_log_t *log, const void *payload);
+
+// Faz no máximo uma operação adiada (gravar a página cheia ou apagar o próximo
+// setor); chamar com idle = true quando uma pausa na rede não atrapalha.
+void flash_log_service(flash_log_t *log, bool idle);
+
+// Grava a página atual mesmo incompleta (antes de um reset, por exemplo)
+bool flash_log_flush(flash_log_t *log);
+
+// Menor seq ainda guardada
+uint32_t flash_log_oldest(const flash_log_t *log);
+
+// Posiciona o iterador no primeiro registro com seq >= seq (ou no mais antigo)
+void flash_log_seek(const flash_log_t *log, flash_log_iter_t *it, uint32_t seq);
+
+// Próximo registro válido em ordem de seq; false ao alcançar o fim do log
+bool flash_log_next(const flash_log_t *log, flash_log_iter_t *it, uint32_t *seq, void *payload);
+
+#endif
@@ -0,0 +1,265 @@
+#include <string.h>
+#include <strings.h>
+#include "http_parser.h"
+
+enum {
+    ST_METHOD,
+    ST_PATH,
+    ST_QUERY,
+    ST_VERSION,
+    ST_HEADER_NAME,      // Início de linha: nome do cabeçalho ou linha vazia
+    ST_HEADER_SPACE,     // Espaços depois de ':'
+    ST_HEADER_VALUE,
+    ST_BODY,
+    ST_DONE,
+    ST_ERROR
+};
+
+// Cabeçalhos que o servidor usa
+enum {
+    HDR_IGNORED,
+    HDR_CONTENT_LENGTH,
+    HDR_CONNECTION,
+    HDR_IF_NONE_MATCH
+};
+
+void http_parser_reset(http_parser_t *p) {
+    memset(p, 0, sizeof(*p));
+    p->state = ST_METHOD;
+}
+
+http_parse_status_t http_parser_status(const http_parser_t *p) {
+    if (p->state == ST_DONE) {
+        return HTTP_PARSE_DONE;
+    }
+    return p->state == ST_ERROR ? HTTP_PARSE_ERROR : HTTP_PARSE_INCOMPLETE;
+}
+
+static void fail(http_parser_t *p, http_parse_error_t error) {
+    p->error = error;
+    p->state = ST_ERROR;
+}
+
+static void token_put(http_parser_t *p, char c) {
+    if (p->token_len < HTTP_PARSER_MAX_VALUE) {
+        p->token[p->token_len++] = c;
+    } else {
+        p->truncated = true;
+    }
+}
+
+// Fim do token atual: termina em NUL e tira espaços à direita
+static const char *token_end(http_parser_t *p) {
+    while (p->token_len && p->token[p->token_len - 1] == ' ') {
+        p->token_len--;
+    }
+    p->token[p->token_len] = '\0';
+    return p->token;
+}
+
+static bool value_has(const char *value, const char *text) {
+    size_t n = strlen(text);
+    for (; *value; value++) {
+        if (strncasecmp(value, text, n) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void header_name_done(http_parser_t *p) {
+    const char *name = token_end(p);
+    if (p->truncated) {
+        p->header = HDR_IGNORED;
+    } else if (strcasecmp(name, "Content-Length") == 0) {
+        p->header = HDR_CONTENT_LENGTH;
+    } else if (strcasecmp(name, "Connection") == 0) {
+        p->header = HDR_CONNECTION;
+    } else if (strcasecmp(name, "If-None-Match") == 0) {
+        p->header = HDR_IF_NONE_MATCH;
+    } else {
+        p->header = HDR_IGNORED;
+    }
+}
+
+static void header_value_done(http_parser_t *p) {
+    const char *value = token_end(p);
+    switch (p->header) {
+        case HDR_CONTENT_LENGTH: {
+            uint32_t n = 0;
+            if (!*value || p->truncated) {
+                fail(p, HTTP_PARSE_BAD_REQUEST);
+                return;
+            }
+            for (; *value; value++) {
+                if (*value < '0' || *value > '9') {
+                    fail(p, HTTP_PARSE_BAD_REQUEST);
+                    return;
+                }
+                n = n * 10 + (*value - '0');
+                if (n > HTTP_PARSER_MAX_BODY) {
+                    fail(p, HTTP_PARSE_BODY_TOO_LARGE);
+                    return;
+                }
+            }
+            p->content_length = n;
+            break;
+        }
+        case HDR_CONNECTION:
+            p->conn_close |= value_has(value, "close");
+            p->conn_keep_alive |= value_has(value, "keep-alive");
+            break;
+        case HDR_IF_NONE_MATCH:
+            // Valor cortado nunca deve casar com um ETag
+            if (!p->truncated) {
+                memcpy(p->if_none_match, value, p->token_len + 1);
+            }
+            break;
+    }
+}
+
+static void version_done(http_parser_t *p) {
+    const char *version = token_end(p);
+    if (strncmp(version, "HTTP/1.", 7) != 0 || p->truncated) {
+        fail(p, HTTP_PARSE_BAD_REQUEST);
+        return;
+    }
+    p->http11 = strcmp(version, "HTTP/1.1") == 0;
+}
+
+static void method_done(http_parser_t *p) {
+    const char *method = token_end(p);
+    if (strcmp(method, "GET") == 0) {
+        p->method = HTTP_METHOD_GET;
+    } else if (strcmp(method, "POST") == 0) {
+        p->method = HTTP_METHOD_POST;
+    } else if (p->token_len == 0) {
+        fail(p, HTTP_PARSE_BAD_REQUEST);
+    } else {
+        p->method = HTTP_METHOD_OTHER;
+    }
+}
+
+// Avança um byte da linha de requisição ou dos cabeçalhos
+static void parse_head(http_parser_t *p, char c) {
+    if (++p->header_bytes > HTTP_PARSER_MAX_HEADER) {
+        fail(p, HTTP_PARSE_HEADERS_TOO_LARGE);
+        return;
+    }
+    if (c == '\r') {
+        return;  // Aceita "\r\n" e "\n" como fim de linha
+    }
+
+    switch (p->state) {
+        case ST_METHOD:
+            if (c == ' ') {
+                method_done(p);
+                if (p->state != ST_ERROR) {
+                    p->state = ST_PATH;
+                }
+            } else if (c == '\n' || p->token_len >= 7) {
+                fail(p, HTTP_PARSE_BAD_REQUEST);
+            } else {
+                token_put(p, c);
+            }
+            break;
+
+        case ST_PATH:
+        case ST_QUERY: {
+            if (c == ' ') {
+                p->token_len = 0;
+                p->truncated = false;
+                p->state = ST_VERSION;
+                break;
+            }
+            if (c == '\n') {
+                fail(p, HTTP_PARSE_BAD_REQUEST);
+                break;
+            }
+            if (c == '?' && p->state == ST_PATH) {
+                p->state = ST_QUERY;
+                break;
+            }
+            char *field = p->state == ST_PATH ? p->path : p->query;
+            size_t max = p->state == ST_PATH ? HTTP_PARSER_MAX_PATH : HTTP_PARSER_MAX_QUERY;
+            size_t n = strlen(field);
+            if (n >= max) {
+                fail(p, HTTP_PARSE_URI_TOO_LONG);
+                break;
+            }
+            field[n] = c;
+            break;
+        }
+
+        case ST_VERSION:
+            if (c == '\n') {
+                version_done(p);
+                if (p->state != ST_ERROR) {
+                    p->token_len = 0;
+                    p->state = ST_HEADER_NAME;
+                }
+            } else {
+                token_put(p, c);
+            }
+            break;
+
+        case ST_HEADER_NAME:
+            if (c == '\n') {
+                if (p->token_len != 0) {
+                    fail(p, HTTP_PARSE_BAD_REQUEST);  // Linha sem ':'
+                } else {
+                    p->state = p->content_length ? ST_BODY : ST_DONE;
+                }
+            } else if (c == ':') {
+                header_name_done(p);
+                p->token_len = 0;
+                p->truncated = false;
+                p->state = ST_HEADER_SPACE;
+            } else {
+                token_put(p, c);
+            }
+            break;
+
+        case ST_HEADER_SPACE:
+            if (c == ' ' || c == '\t') {
+                break;
+            }
+            p->state = ST_HEADER_VALUE;
+            // fall through
+        case ST_HEADER_VALUE:
+            if (c == '\n') {
+                header_value_done(p);
+                if (p->state != ST_ERROR) {
+                    p->token_len = 0;
+                    p->truncated = false;
+                    p->state = ST_HEADER_NAME;
+                }
+            } else if (p->header != HDR_IGNORED) {
+                token_put(p, c);
+            }
+            break;
+    }
+}
+
+size_t http_parser_feed(http_parser_t *p, const char *data, size_t len) {
+    size_t used = 0;
+    while (used < len && p->state != ST_DONE && p->state != ST_ERROR) {
+        if (p->state == ST_BODY) {
+            // Corpo: cópia em bloco até completar Content-Length
+            size_t n = p->content_length - p->body_len;
+            if (n > len - used) {
+                n = len - used;
+            }
+            memcpy(p->body + p->body_len, data + used, n);
+            p->body_len += n;
+            used += n;
+            if (p->body_len == p->content_length) {
+                p->body[p->body_len] = '\0';
+                p->state = ST_DONE;
+            }
+        } else {
+            parse_head(p, data[used++]);
+        }
+    }
+    return used;
+}
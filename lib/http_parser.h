@@ -0,0 +1,73 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Limites de uma requisição
+#define HTTP_PARSER_MAX_HEADER 1024   // Linha de requisição + cabeçalhos
+#define HTTP_PARSER_MAX_BODY   384
+#define HTTP_PARSER_MAX_PATH   48
+#define HTTP_PARSER_MAX_QUERY  32
+#define HTTP_PARSER_MAX_VALUE  64     // Valor de um cabeçalho que interessa ao servidor
+
+typedef enum {
+    HTTP_METHOD_OTHER,
+    HTTP_METHOD_GET,
+    HTTP_METHOD_POST
+} http_method_t;
+
+typedef enum {
+    HTTP_PARSE_INCOMPLETE,   // Precisa de mais bytes
+    HTTP_PARSE_DONE,         // Requisição completa; os campos abaixo são válidos
+    HTTP_PARSE_ERROR         // Ver http_parser_t.error
+} http_parse_status_t;
+
+typedef enum {
+    HTTP_PARSE_OK,
+    HTTP_PARSE_BAD_REQUEST,        // 400
+    HTTP_PARSE_URI_TOO_LONG,       // 414
+    HTTP_PARSE_HEADERS_TOO_LARGE,  // 431
+    HTTP_PARSE_BODY_TOO_LARGE      // 413
+} http_parse_error_t;
+
+// Parser incremental: recebe a requisição em pedaços de qualquer tamanho (cada
+// pbuf de uma cadeia, em vários callbacks de recv) e guarda só o que o servidor
+// usa: método, rota, query, Connection, If-None-Match e o corpo.
+typedef struct {
+    http_method_t method;
+    char path[HTTP_PARSER_MAX_PATH + 1];
+    char query[HTTP_PARSER_MAX_QUERY + 1];
+    bool http11;
+    bool conn_close;               // "Connection: close"
+    bool conn_keep_alive;          // "Connection: keep-alive"
+    char if_none_match[HTTP_PARSER_MAX_VALUE + 1];
+    uint32_t content_length;
+    char body[HTTP_PARSER_MAX_BODY + 1];   // Terminado em NUL
+    http_parse_error_t error;
+
+    // Estado interno
+    uint8_t state;
+    uint16_t header_bytes;
+    uint16_t body_len;
+    uint8_t token_len;
+    char token[HTTP_PARSER_MAX_VALUE + 1]; // Método, versão, nome ou valor em andamento
+    uint8_t header;                        // Cabeçalho cujo valor está sendo lido
+    bool truncated;
+} http_parser_t;
+
+void http_parser_reset(http_parser_t *p);
+
+// Consome até len bytes e retorna quantos usou. Para no fim da requisição, então
+// bytes de uma próxima requisição em pipeline ficam para depois do reset.
+size_t http_parser_feed(http_parser_t *p, const char *data, size_t len);
+
+http_parse_status_t http_parser_status(const http_parser_t *p);
+
+// HTTP/1.1 mantém a conexão por padrão; HTTP/1.0 só com "Connection: keep-alive"
+static inline bool http_parser_keep_alive(const http_parser_t *p) {
+    return p->http11 ? !p->conn_close : p->conn_keep_alive;
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include <string.h>
+#include "json_writer.h"
+
+static const uint32_t pow10_table[] = { 1, 10, 100, 1000, 10000, 100000 };
+
+static void put(json_writer_t *w, const char *s, size_t n) {
+    if (w->overflow || n > w->cap - w->len) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static void putc_json(json_writer_t *w, char c) {
+    put(w, &c, 1);
+}
+
+// Vírgula antes de todo item que não é o primeiro do container
+static void separator(json_writer_t *w) {
+    if (w->after_key) {
+        w->after_key = false;
+        return;
+    }
+    uint8_t bit = 1u << w->depth;
+    if (w->has_items & bit) {
+        putc_json(w, ',');
+    }
+    w->has_items |= bit;
+}
+
+// Dígitos de value com pelo menos min_digits (zeros à esquerda)
+static void put_digits(json_writer_t *w, uint32_t value, uint8_t min_digits) {
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[sizeof(tmp) - 1 - n++] = '0' + value % 10;
+        value /= 10;
+    } while (value || n < min_digits);
+    put(w, tmp + sizeof(tmp) - n, n);
+}
+
+void json_init(json_writer_t *w, char *buf, size_t cap) {
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->cap = cap;
+}
+
+static void open_container(json_writer_t *w, char c) {
+    separator(w);
+    putc_json(w, c);
+    if (w->depth + 1 >= JSON_MAX_DEPTH) {
+        w->overflow = true;
+        return;
+    }
+    w->depth++;
+    w->has_items &= ~(1u << w->depth);
+}
+
+static void close_container(json_writer_t *w, char c) {
+    if (w->depth == 0) {
+        w->overflow = true;
+        return;
+    }
+    w->depth--;
+    putc_json(w, c);
+}
+
+void json_object_begin(json_writer_t *w) { open_container(w, '{'); }
+void json_object_end(json_writer_t *w)   { close_container(w, '}'); }
+void json_array_begin(json_writer_t *w)  { open_container(w, '['); }
+void json_array_end(json_writer_t *w)    { close_container(w, ']'); }
+
+void json_key(json_writer_t *w, const char *key) {
+    separator(w);
+    putc_json(w, '"');
+    put(w, key, strlen(key));
+    put(w, "\":", 2);
+    w->after_key = true;
+}
+
+void json_uint(json_writer_t *w, uint32_t value) {
+    separator(w);
+    put_digits(w, value, 1);
+}
+
+void json_bool(json_writer_t *w, bool value) {
+    separator(w);
+    if (value) {
+        put(w, "true", 4);
+    } else {
+        put(w, "false", 5);
+    }
+}
+
+void json_string(json_writer_t *w, const char *s) {
+    separator(w);
+    putc_json(w, '"');
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            putc_json(w, '\\');
+        }
+        putc_json(w, *s);
+    }
+    putc_json(w, '"');
+}
+
+void json_fixed(json_writer_t *w, int32_t value, uint8_t decimals) {
+    separator(w);
+    if (decimals >= sizeof(pow10_table) / sizeof(pow10_table[0])) {
+        decimals = sizeof(pow10_table) / sizeof(pow10_table[0]) - 1;
+    }
+    uint32_t mag = value < 0 ? -(uint32_t)value : (uint32_t)value;
+    uint32_t scale = pow10_table[decimals];
+    if (value < 0) {
+        putc_json(w, '-');
+    }
+    put_digits(w, mag / scale, 1);
+    if (decimals) {
+        putc_json(w, '.');
+        put_digits(w, mag % scale, decimals);
+    }
+}
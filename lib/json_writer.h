@@ -0,0 +1,46 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Profundidade máxima de objetos/arrays aninhados
+#define JSON_MAX_DEPTH 8
+
+// Escritor de JSON em um buffer fixo: sem alocação, sem printf e em uma só passada.
+// Vírgulas entre itens são colocadas automaticamente. Se o buffer acabar, a escrita
+// para e json_ok() passa a retornar false.
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t len;
+    uint8_t depth;
+    uint8_t has_items;     // Bit por nível: o container atual já tem itens
+    bool after_key;        // Próximo valor pertence a uma chave (sem vírgula)
+    bool overflow;
+} json_writer_t;
+
+void json_init(json_writer_t *w, char *buf, size_t cap);
+
+void json_object_begin(json_writer_t *w);
+void json_object_end(json_writer_t *w);
+void json_array_begin(json_writer_t *w);
+void json_array_end(json_writer_t *w);
+
+// Escreve "key": (a chave não é escapada; use só nomes fixos)
+void json_key(json_writer_t *w, const char *key);
+
+void json_uint(json_writer_t *w, uint32_t value);
+void json_bool(json_writer_t *w, bool value);
+void json_string(json_writer_t *w, const char *s);
+
+// Decimal em ponto fixo: value em unidades de 10^-decimals (2534, 2 -> 25.34)
+void json_fixed(json_writer_t *w, int32_t value, uint8_t decimals);
+
+// true se tudo coube no buffer
+static inline bool json_ok(const json_writer_t *w) {
+    return !w->overflow && w->depth == 0;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include "measurement.h"
+
+static const int32_t pow10_table[] = { 1, 10, 100, 1000, 10000, 100000 };
+
+size_t fixed_format(char *buf, size_t cap, int32_t value, uint8_t decimals, uint8_t shown) {
+    if (shown < decimals) {
+        value = fixed_div_round(value, pow10_table[decimals - shown]);
+    }
+    uint32_t mag = value < 0 ? -(uint32_t)value : (uint32_t)value;
+    uint32_t scale = pow10_table[shown];
+    int n = shown
+        ? snprintf(buf, cap, "%s%lu.%0*lu", value < 0 ? "-" : "", (unsigned long)(mag / scale),
+                   (int)shown, (unsigned long)(mag % scale))
+        : snprintf(buf, cap, "%s%lu", value < 0 ? "-" : "", (unsigned long)mag);
+    return n < 0 ? 0 : ((size_t)n < cap ? (size_t)n : cap - 1);
+}
+
+const char *fixed_parse(const char *s, uint8_t decimals, int32_t *out) {
+    bool negative = false;
+    bool digits = false;
+    int64_t value = 0;
+    uint8_t frac = 0;
+    int round = 0;
+
+    if (*s == '-' || *s == '+') {
+        negative = *s++ == '-';
+    }
+    for (; *s >= '0' && *s <= '9'; s++) {
+        value = value * 10 + (*s - '0');
+        digits = true;
+        if (value > INT32_MAX) {
+            return NULL;
+        }
+    }
+    if (*s == '.') {
+        for (s++; *s >= '0' && *s <= '9'; s++) {
+            if (frac < decimals) {
+                value = value * 10 + (*s - '0');
+                frac++;
+            } else if (frac == decimals) {
+                round = *s >= '5';  // Só a primeira casa extra decide
+                frac++;
+            }
+            digits = true;
+        }
+    }
+    if (!digits) {
+        return NULL;
+    }
+    for (; frac < decimals; frac++) {
+        value *= 10;
+    }
+    value += round;
+    if (value > INT32_MAX) {
+        return NULL;
+    }
+    *out = negative ? -(int32_t)value : (int32_t)value;
+    return s;
+}
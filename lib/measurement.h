@@ -0,0 +1,42 @@
+#ifndef MEASUREMENT_H
+#define MEASUREMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Casas decimais de todas as grandezas na unidade exibida (°C, %UR, hPa, m, g/m³)
+#define MEASUREMENT_DECIMALS 2
+
+// Amostra em ponto fixo, do sensor até o histórico. Temperatura e umidade em
+// centésimos (°C, %UR), pressão em Pa (centésimos de hPa), altitude em cm.
+// As derivadas (lib/derived.h) seguem a mesma escala: centésimos de °C e de
+// g/m³. Só o display e a API convertem para texto.
+typedef struct {
+    int32_t temperature;
+    int32_t humidity;
+    int32_t pressure;
+    int32_t altitude;
+    int32_t dew_point;
+    int32_t abs_humidity;
+    int32_t heat_index;
+} measurement_t;
+
+// Divisão arredondada ao mais próximo (metade se afasta do zero), sem
+// estourar perto de INT32_MIN e INT32_MAX. divisor > 0.
+static inline int32_t fixed_div_round(int32_t value, int32_t divisor) {
+    int32_t q = value / divisor, r = value % divisor;
+    if (2 * (r < 0 ? -r : r) >= divisor) {
+        q += value < 0 ? -1 : 1;
+    }
+    return q;
+}
+
+// Texto de value (em unidades de 10^-decimals) com shown casas, arredondado.
+// Retorna o tamanho escrito (sem o '\0').
+size_t fixed_format(char *buf, size_t cap, int32_t value, uint8_t decimals, uint8_t shown);
+
+// Lê um número decimal ("-12.5", "1013", "2e1" não) em unidades de
+// 10^-decimals, arredondando casas a mais. Retorna o fim do número ou NULL.
+const char *fixed_parse(const char *s, uint8_t decimals, int32_t *out);
+
+#endif
@@ -0,0 +1,30 @@
+#include "pipeline.h"
+#include "hardware/structs/systick.h"
+
+bool pipeline_run(pipeline_t *p, measurement_t *m) {
+    uint32_t total = 0;
+
+    for (uint8_t i = 0; i < p->count; i++) {
+        pipeline_stage_t *st = &p->stages[i];
+        uint32_t start = systick_hw->cvr;
+        bool ok = st->fn(m);
+        uint32_t cycles = (start - systick_hw->cvr) & 0x00FFFFFF;  // Contador decrescente de 24 bits
+
+        st->runs++;
+        st->cycles = cycles;
+        if (cycles > st->cycles_max) {
+            st->cycles_max = cycles;
+        }
+        total += cycles;
+        if (!ok) {
+            st->stops++;
+            return false;
+        }
+    }
+    p->samples++;
+    p->cycles = total;
+    if (total > p->cycles_max) {
+        p->cycles_max = total;
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "measurement.h"
+
+// Estágio do processamento de uma amostra: lê e completa o registro. false
+// interrompe a amostra (ex.: sensor ainda sem dado novo) e pula o resto.
+typedef bool (*pipeline_fn_t)(measurement_t *m);
+
+typedef struct {
+    const char *name;
+    pipeline_fn_t fn;
+    uint32_t runs;
+    uint32_t stops;                      // Amostras interrompidas neste estágio
+    uint32_t cycles;                     // Ciclos da última execução (SysTick)
+    uint32_t cycles_max;
+} pipeline_stage_t;
+
+// Estágios rodam uma vez por amostra, em ordem de tabela, sobre o mesmo
+// registro. Os tempos vêm do SysTick do núcleo, que precisa estar contando
+// com recarga 0xFFFFFF. Estatísticas em palavras de 32 bits, como no
+// escalonador.
+typedef struct {
+    pipeline_stage_t *stages;
+    uint8_t count;
+    uint32_t samples;                    // Amostras que passaram por todos os estágios
+    uint32_t cycles;                     // Ciclos da última amostra completa
+    uint32_t cycles_max;
+} pipeline_t;
+
+#define PIPELINE_INIT(table) \
+    { .stages = (table), .count = sizeof(table) / sizeof((table)[0]) }
+
+// Roda os estágios sobre m; true se a amostra chegou ao fim
+bool pipeline_run(pipeline_t *p, measurement_t *m);
+
+#endif
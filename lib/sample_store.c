@@ -0,0 +1,266 @@
+#include <string.h>
+#include "sample_store.h"
+
+#define RICE_LIMIT 10        // Uns seguidos que abrem um escape
+#define RICE_RAW_BITS 17     // Erro em zigzag entre dois int16 cabe em 17 bits
+#define MEAN_CAP 8191        // Teto do erro somado à média (x8 cabe em 16 bits)
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Tamanho do código de prefixo do tempo para um valor em zigzag
+static unsigned code_bits(uint32_t zz) {
+    if (zz == 0) {
+        return 1;
+    }
+    if (zz < (1u << 3)) {
+        return 2 + 3;
+    }
+    if (zz < (1u << 6)) {
+        return 3 + 6;
+    }
+    if (zz < (1u << 9)) {
+        return 4 + 9;
+    }
+    return 4 + 32;
+}
+
+static void put_bits(sample_block_t *b, uint32_t value, unsigned n) {
+    while (n--) {
+        uint16_t pos = b->bits++;
+        uint8_t mask = 0x80 >> (pos & 7);
+        if ((value >> n) & 1) {
+            b->data[pos >> 3] |= mask;
+        } else {
+            b->data[pos >> 3] &= ~mask;
+        }
+    }
+}
+
+static uint32_t get_bits(const sample_block_t *b, uint16_t *pos, unsigned n) {
+    uint32_t value = 0;
+    while (n--) {
+        value = (value << 1) | ((b->data[*pos >> 3] >> (7 - (*pos & 7))) & 1);
+        (*pos)++;
+    }
+    return value;
+}
+
+static void put_code(sample_block_t *b, uint32_t zz) {
+    if (zz == 0) {
+        put_bits(b, 0x0, 1);
+    } else if (zz < (1u << 3)) {
+        put_bits(b, 0x2, 2);
+        put_bits(b, zz, 3);
+    } else if (zz < (1u << 6)) {
+        put_bits(b, 0x6, 3);
+        put_bits(b, zz, 6);
+    } else if (zz < (1u << 9)) {
+        put_bits(b, 0xE, 4);
+        put_bits(b, zz, 9);
+    } else {
+        put_bits(b, 0xF, 4);
+        put_bits(b, zz, 32);
+    }
+}
+
+static uint32_t get_code(const sample_block_t *b, uint16_t *pos) {
+    unsigned ones = 0;
+    while (ones < 4 && get_bits(b, pos, 1)) {
+        ones++;
+    }
+    static const uint8_t widths[] = { 0, 3, 6, 9, 32 };
+    return get_bits(b, pos, widths[ones]);
+}
+
+// Rice: q = zz >> k em unário ('1' x q, '0') e os k bits baixos. Com
+// RICE_LIMIT uns vem um escape: '0' + o valor em RICE_RAW_BITS, ou '1', o
+// marcador de tempo (só antes do primeiro canal) seguido de put_code.
+static unsigned rice_bits(uint32_t zz, unsigned k) {
+    uint32_t q = zz >> k;
+    return q < RICE_LIMIT ? q + 1 + k : RICE_LIMIT + 1 + RICE_RAW_BITS;
+}
+
+static void put_rice(sample_block_t *b, uint32_t zz, unsigned k) {
+    uint32_t q = zz >> k;
+    if (q < RICE_LIMIT) {
+        put_bits(b, (1u << (q + 1)) - 2, q + 1);
+        put_bits(b, zz, k);
+    } else {
+        put_bits(b, (1u << (RICE_LIMIT + 1)) - 2, RICE_LIMIT + 1);
+        put_bits(b, zz, RICE_RAW_BITS);
+    }
+}
+
+// false: no lugar do valor veio o marcador de tempo
+static bool get_rice(const sample_block_t *b, uint16_t *pos, unsigned k, uint32_t *zz) {
+    uint32_t q = 0;
+    while (q < RICE_LIMIT && get_bits(b, pos, 1)) {
+        q++;
+    }
+    if (q < RICE_LIMIT) {
+        *zz = (q << k) | get_bits(b, pos, k);
+        return true;
+    }
+    if (get_bits(b, pos, 1)) {
+        return false;
+    }
+    *zz = get_bits(b, pos, RICE_RAW_BITS);
+    return true;
+}
+
+// k do Rice: o maior com 2^k <= erro médio + 3/4
+static unsigned rice_k(uint16_t mean) {
+    unsigned k = 0;
+    while (((uint32_t)mean + 6) >> (k + 4)) {
+        k++;
+    }
+    return k;
+}
+
+// Previsão e erro médio de cada canal, iguais no codificador e no cursor.
+// Média exponencial de peso 1/2: acompanha a tendência e corta parte do ruído.
+static int32_t predict(int32_t level) {
+    return (level + 1) >> 1;
+}
+
+static void channels_reset(int32_t *level, uint16_t *mean, const int16_t *values) {
+    for (int i = 0; i < SAMPLE_STORE_CHANNELS; i++) {
+        level[i] = 2 * values[i];
+        mean[i] = 0;
+    }
+}
+
+static void channel_update(int32_t *level, uint16_t *mean, int16_t value, uint32_t zz) {
+    *level += (2 * value - *level) >> 1;
+    *mean += ((int32_t)(zz < MEAN_CAP ? zz : MEAN_CAP) * 8 - *mean) >> 3;
+}
+
+void sample_store_init(sample_store_t *s, sample_block_t *blocks, uint16_t block_count) {
+    memset(s, 0, sizeof(*s));
+    memset(blocks, 0, block_count * sizeof(*blocks));
+    s->blocks = blocks;
+    s->block_count = block_count;
+}
+
+static uint32_t oldest_block(const sample_store_t *s) {
+    return s->head + 1 > s->block_count ? s->head + 1 - s->block_count : 0;
+}
+
+// Tenta codificar a amostra no fim do bloco; false se não cabe
+static bool block_append(sample_store_t *s, sample_block_t *b, int32_t delta, const int16_t *values) {
+    uint32_t zz[SAMPLE_STORE_CHANNELS];
+    unsigned bits = 0;
+
+    if (delta != SAMPLE_STORE_PERIOD_S) {
+        bits += RICE_LIMIT + 1 + code_bits(zigzag(delta - SAMPLE_STORE_PERIOD_S));
+    }
+    for (int i = 0; i < SAMPLE_STORE_CHANNELS; i++) {
+        zz[i] = zigzag((int32_t)values[i] - predict(s->level[i]));
+        bits += rice_bits(zz[i], rice_k(s->mean[i]));
+    }
+    if (b->bits + bits > SAMPLE_BLOCK_BYTES * 8) {
+        return false;
+    }
+    if (delta != SAMPLE_STORE_PERIOD_S) {
+        put_bits(b, (1u << (RICE_LIMIT + 1)) - 1, RICE_LIMIT + 1);
+        put_code(b, zigzag(delta - SAMPLE_STORE_PERIOD_S));
+    }
+    for (int i = 0; i < SAMPLE_STORE_CHANNELS; i++) {
+        put_rice(b, zz[i], rice_k(s->mean[i]));
+        channel_update(&s->level[i], &s->mean[i], values[i], zz[i]);
+    }
+    b->count++;
+    return true;
+}
+
+void sample_store_append(sample_store_t *s, uint32_t time_s, const int16_t *values) {
+    sample_block_t *b = &s->blocks[s->head % s->block_count];
+    int32_t delta = (int32_t)(time_s - s->last_time);
+
+    if (b->count == 0 || !block_append(s, b, delta, values)) {
+        if (b->count) {
+            // Bloco cheio: abre o próximo (o mais antigo do anel é descartado)
+            s->head++;
+            b = &s->blocks[s->head % s->block_count];
+        }
+        b->first_time = time_s;
+        memcpy(b->first, values, sizeof(b->first));
+        b->count = 1;
+        b->bits = 0;
+        channels_reset(s->level, s->mean, values);
+    }
+
+    s->last_time = time_s;
+    s->samples++;
+}
+
+uint32_t sample_store_count(const sample_store_t *s) {
+    uint32_t n = 0;
+    for (uint32_t id = oldest_block(s); id <= s->head; id++) {
+        n += s->blocks[id % s->block_count].count;
+    }
+    return n;
+}
+
+size_t sample_store_bytes(const sample_store_t *s) {
+    size_t n = 0;
+    for (uint32_t id = oldest_block(s); id <= s->head; id++) {
+        const sample_block_t *b = &s->blocks[id % s->block_count];
+        if (b->count) {
+            n += offsetof(sample_block_t, data) + (b->bits + 7) / 8;
+        }
+    }
+    return n;
+}
+
+void sample_store_begin(const sample_store_t *s, sample_cursor_t *c) {
+    memset(c, 0, sizeof(*c));
+    c->block = oldest_block(s);
+}
+
+bool sample_store_next(const sample_store_t *s, sample_cursor_t *c, uint32_t *time_s, int16_t *values) {
+    if (c->block < oldest_block(s)) {
+        sample_store_begin(s, c);
+    }
+    const sample_block_t *b = &s->blocks[c->block % s->block_count];
+    if (c->index >= b->count) {
+        if (c->block >= s->head) {
+            return false;
+        }
+        c->block++;
+        c->index = 0;
+        c->bitpos = 0;
+        b = &s->blocks[c->block % s->block_count];
+        if (b->count == 0) {
+            return false;
+        }
+    }
+
+    if (c->index == 0) {
+        c->time = b->first_time;
+        memcpy(c->value, b->first, sizeof(c->value));
+        channels_reset(c->level, c->mean, c->value);
+    } else {
+        int32_t delta = SAMPLE_STORE_PERIOD_S;
+        for (int i = 0; i < SAMPLE_STORE_CHANNELS; i++) {
+            uint32_t zz;
+            while (!get_rice(b, &c->bitpos, rice_k(c->mean[i]), &zz)) {
+                delta += unzigzag(get_code(b, &c->bitpos));
+            }
+            c->value[i] = (int16_t)(predict(c->level[i]) + unzigzag(zz));
+            channel_update(&c->level[i], &c->mean[i], c->value[i], zz);
+        }
+        c->time += delta;
+    }
+    c->index++;
+
+    *time_s = c->time;
+    memcpy(values, c->value, sizeof(c->value));
+    return true;
+}
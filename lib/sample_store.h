@@ -0,0 +1,64 @@
+#ifndef SAMPLE_STORE_H
+#define SAMPLE_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SAMPLE_STORE_CHANNELS 3
+#define SAMPLE_BLOCK_BYTES 256
+#define SAMPLE_STORE_PERIOD_S 1                 // Intervalo esperado entre amostras
+
+// Bloco comprimido: a primeira amostra fica em claro no cabeçalho; nas
+// seguintes, cada canal guarda só o erro da previsão (média exponencial de
+// peso 1/2 sobre as amostras anteriores) num código de Rice com k adaptado ao
+// erro médio recente. O tempo não ocupa bits enquanto as amostras vêm a cada
+// SAMPLE_STORE_PERIOD_S; fora disso, um escape antes do primeiro canal leva
+// a diferença.
+typedef struct {
+    uint32_t first_time;                     // Segundos desde o boot
+    int16_t first[SAMPLE_STORE_CHANNELS];
+    uint16_t count;                          // Amostras no bloco (0: vazio)
+    uint16_t bits;                           // Bits usados em data
+    uint8_t data[SAMPLE_BLOCK_BYTES];
+} sample_block_t;
+
+// Anel de blocos só de acréscimo; quando enche, o bloco mais antigo é descartado inteiro
+typedef struct {
+    sample_block_t *blocks;
+    uint16_t block_count;
+    uint32_t head;                           // Id absoluto do bloco em escrita
+    uint32_t samples;                        // Amostras acrescentadas desde o boot
+    // Estado do codificador (depois da última amostra escrita)
+    uint32_t last_time;
+    int32_t level[SAMPLE_STORE_CHANNELS];    // Previsão, em meios LSB
+    uint16_t mean[SAMPLE_STORE_CHANNELS];    // Erro médio recente em zigzag, x8
+} sample_store_t;
+
+// Posição de leitura sequencial; continua válida entre chamadas e após novos acréscimos
+typedef struct {
+    uint32_t block;                          // Id absoluto
+    uint16_t index;                          // Próxima amostra dentro do bloco
+    uint16_t bitpos;
+    uint32_t time;
+    int16_t value[SAMPLE_STORE_CHANNELS];
+    int32_t level[SAMPLE_STORE_CHANNELS];
+    uint16_t mean[SAMPLE_STORE_CHANNELS];
+} sample_cursor_t;
+
+void sample_store_init(sample_store_t *s, sample_block_t *blocks, uint16_t block_count);
+
+void sample_store_append(sample_store_t *s, uint32_t time_s, const int16_t *values);
+
+// Amostras ainda guardadas e bytes ocupados por elas
+uint32_t sample_store_count(const sample_store_t *s);
+size_t sample_store_bytes(const sample_store_t *s);
+
+// Cursor na amostra mais antiga guardada
+void sample_store_begin(const sample_store_t *s, sample_cursor_t *c);
+
+// Decodifica a próxima amostra; false quando chegou à mais nova. Se o bloco
+// do cursor foi descartado, pula para o mais antigo ainda guardado.
+bool sample_store_next(const sample_store_t *s, sample_cursor_t *c, uint32_t *time_s, int16_t *values);
+
+#endif
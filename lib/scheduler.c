@@ -0,0 +1,145 @@
+#include "scheduler.h"
+#include "hardware/structs/scb.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+
+static void add_ms(uint32_t *ms, uint32_t *rem_us, uint32_t us) {
+    *rem_us += us;
+    *ms += *rem_us / 1000;
+    *rem_us %= 1000;
+}
+
+// Periódicas sempre têm prazo; as de disparo único, só depois de sched_after
+static bool scheduled(const sched_task_t *t) {
+    return t->period_us || t->deadline_us;
+}
+
+static int64_t wake_callback(alarm_id_t id, void *user_data) {
+    sched_t *s = user_data;
+    if (id == s->alarm) {
+        s->alarm = 0;  // Já disparou: não cancelar (o id pode ser reutilizado)
+    }
+    s->wake = true;
+    return 0;
+}
+
+void sched_start(sched_t *s, alarm_pool_t *pool) {
+    uint64_t now = time_us_64();
+    for (uint8_t i = 0; i < s->count; i++) {
+        if (s->tasks[i].period_us) {
+            s->tasks[i].deadline_us = now;
+        }
+    }
+    s->core = get_core_num();
+    s->pool = pool;
+    // IRQ que fica pendente com as interrupções mascaradas também acorda o __wfe()
+    scb_hw->scr |= M0PLUS_SCR_SEVONPEND_BITS;
+}
+
+void sched_after(sched_t *s, uint8_t task, uint32_t delay_us) {
+    s->tasks[task].deadline_us = time_us_64() + delay_us;
+}
+
+void sched_trigger(sched_t *s, uint8_t task) {
+    s->tasks[task].triggered = true;
+    s->wake = true;
+    // O evento tira o dono do __wfe() mesmo vindo do outro núcleo; no próprio
+    // núcleo só faz a próxima espera voltar na hora, e o laço já vê o wake
+    __dmb();
+    __sev();
+}
+
+static void run_task(sched_task_t *t, uint64_t now) {
+    bool due = scheduled(t) && t->deadline_us <= now;
+    uint64_t start = time_us_64();
+
+    t->triggered = false;
+    if (due) {
+        uint32_t late = start - t->deadline_us;
+        if (late > t->max_late_us) {
+            t->max_late_us = late;
+        }
+    }
+
+    t->fn();
+
+    uint64_t end = time_us_64();
+    uint32_t elapsed = end - start;
+    t->runs++;
+    if (elapsed > t->max_us) {
+        t->max_us = elapsed;
+    }
+    add_ms(&t->busy_ms, &t->busy_rem_us, elapsed);
+
+    if (!due) {
+        return;  // Disparo avulso: o prazo periódico continua o mesmo
+    }
+    if (!t->period_us) {
+        t->deadline_us = 0;
+        return;
+    }
+    // Mantém a fase; ativações que já passaram são puladas e contadas
+    t->deadline_us += t->period_us;
+    if (t->deadline_us <= end) {
+        uint32_t missed = (end - t->deadline_us) / t->period_us + 1;
+        t->overruns += missed;
+        t->deadline_us += (uint64_t)missed * t->period_us;
+    }
+}
+
+// Dorme até o prazo (UINT64_MAX: até um disparo). As interrupções ficam
+// mascaradas entre testar wake e o __wfe(): uma IRQ que fica pendente (com
+// SEVONPEND) ou um __sev() do outro núcleo deixam o evento marcado, então o
+// __wfe() volta na hora e nenhum disparo se perde. Eventos sem wake (de
+// spin locks do SDK, por exemplo) só fazem o laço testar de novo.
+static void sleep_until(sched_t *s, uint64_t deadline) {
+    uint64_t start = time_us_64();
+
+    if (deadline != UINT64_MAX) {
+        // Mascarado: o alarme não dispara antes de o id ficar guardado
+        uint32_t irq = save_and_disable_interrupts();
+        alarm_id_t id = alarm_pool_add_alarm_at(s->pool, from_us_since_boot(deadline),
+                                                wake_callback, s, true);
+        s->alarm = id > 0 ? id : 0;
+        restore_interrupts(irq);
+    }
+    for (;;) {
+        uint32_t irq = save_and_disable_interrupts();
+        if (s->wake) {
+            restore_interrupts(irq);
+            break;
+        }
+        __wfe();
+        restore_interrupts(irq);
+    }
+    if (s->alarm) {
+        alarm_pool_cancel_alarm(s->pool, s->alarm);  // Acordado antes por um disparo
+        s->alarm = 0;
+    }
+    s->wakeups++;
+    add_ms(&s->idle_ms, &s->idle_rem_us, time_us_64() - start);
+}
+
+void sched_run(sched_t *s) {
+    for (;;) {
+        uint64_t next = UINT64_MAX;
+
+        s->wake = false;  // Disparos a partir daqui impedem o próximo sono
+        for (uint8_t i = 0; i < s->count; i++) {
+            sched_task_t *t = &s->tasks[i];
+            uint64_t now = time_us_64();
+            if (t->triggered || (scheduled(t) && t->deadline_us <= now)) {
+                run_task(t, now);
+            }
+        }
+        // Depois da passada: uma tarefa pode ter agendado outra já percorrida
+        for (uint8_t i = 0; i < s->count; i++) {
+            if (scheduled(&s->tasks[i]) && s->tasks[i].deadline_us < next) {
+                next = s->tasks[i].deadline_us;
+            }
+        }
+        if (next > time_us_64()) {
+            sleep_until(s, next);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+typedef void (*sched_fn_t)(void);
+
+// Tarefa cooperativa: roda até o fim, sem bloquear. Com period_us, roda a
+// cada período a partir de sched_start; sem, só quando agendada (sched_after)
+// ou disparada (sched_trigger). As estatísticas são palavras de 32 bits,
+// legíveis do outro núcleo sem trava.
+typedef struct {
+    const char *name;
+    sched_fn_t fn;
+    uint32_t period_us;                  // 0: tarefa de disparo único
+    uint64_t deadline_us;                // Próxima ativação; 0 sem período: nenhuma
+    volatile bool triggered;             // Rodar assim que possível
+    uint32_t runs;
+    uint32_t overruns;                   // Ativações periódicas perdidas
+    uint32_t max_us;                     // Maior tempo de execução
+    uint32_t max_late_us;                // Maior atraso em relação ao prazo
+    uint32_t busy_ms;                    // Tempo total de execução
+    uint32_t busy_rem_us;
+} sched_task_t;
+
+// Um escalonador por núcleo: roda as tarefas vencidas em ordem de tabela e
+// dorme em __wfe() até o próximo prazo, acordado por um alarme do pool ou
+// por um disparo (sched_trigger) de qualquer núcleo.
+typedef struct {
+    sched_task_t *tasks;
+    uint8_t count;
+    uint8_t core;
+    alarm_pool_t *pool;                  // IRQ no núcleo dono
+    alarm_id_t alarm;                    // Alarme do próximo prazo (0: nenhum)
+    volatile bool wake;
+    uint32_t wakeups;
+    uint32_t idle_ms;                    // Tempo dormindo
+    uint32_t idle_rem_us;
+} sched_t;
+
+#define SCHED_INIT(table) \
+    { .tasks = (table), .count = sizeof(table) / sizeof((table)[0]) }
+
+// Chamar no núcleo dono; pool precisa ter a IRQ nesse núcleo
+void sched_start(sched_t *s, alarm_pool_t *pool);
+
+// Laço do escalonador; não retorna
+void sched_run(sched_t *s) __attribute__((noreturn));
+
+// Agenda uma ativação daqui a delay_us (só do núcleo dono, fora de IRQ)
+void sched_after(sched_t *s, uint8_t task, uint32_t delay_us);
+
+// Roda a tarefa o quanto antes; vale de qualquer núcleo ou interrupção
+void sched_trigger(sched_t *s, uint8_t task);
+
+#endif
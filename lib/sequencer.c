@@ -0,0 +1,110 @@
+#include "sequencer.h"
+#include "hardware/clocks.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+
+#define BUZZER_TICK_HZ 1000000           // Contador do buzzer a 1 MHz: tons de 16 Hz a 20 kHz
+#define LED_WRAP 255
+
+static void set_tone(const sequencer_t *s, uint16_t hz) {
+    uint slice = pwm_gpio_to_slice_num(s->buzzer_pin);
+    if (hz < 16) {
+        pwm_set_gpio_level(s->buzzer_pin, 0);
+        return;
+    }
+    uint32_t wrap = BUZZER_TICK_HZ / hz - 1;
+    pwm_set_wrap(slice, wrap);
+    pwm_set_gpio_level(s->buzzer_pin, (wrap + 1) / 2);
+}
+
+static void set_led(const sequencer_t *s, const uint8_t rgb[3]) {
+    for (int i = 0; i < 3; i++) {
+        pwm_set_gpio_level(s->rgb_pins[i], rgb[i]);
+    }
+}
+
+static const seq_step_t *current_step(const sequencer_t *s) {
+    return &s->queue[s->head].steps[s->step];
+}
+
+static void apply_step(const sequencer_t *s) {
+    const seq_step_t *st = current_step(s);
+    const uint8_t rgb[3] = { st->r, st->g, st->b };
+    set_tone(s, st->tone_hz);
+    set_led(s, st->led ? rgb : s->background);
+}
+
+// IRQ do alarme: avança um passo. O retorno negativo reagenda a partir do
+// instante previsto do disparo anterior (o positivo contaria a partir de
+// agora), então a latência da IRQ não se acumula ao longo do padrão.
+static int64_t step_callback(alarm_id_t id, void *user_data) {
+    sequencer_t *s = user_data;
+
+    if (++s->step == s->queue[s->head].count) {
+        s->step = 0;
+        s->head = (s->head + 1) % SEQ_QUEUE_SIZE;
+        if (--s->count == 0) {
+            set_tone(s, 0);
+            set_led(s, s->background);
+            return 0;
+        }
+    }
+    apply_step(s);
+    return -(int64_t)current_step(s)->ms * 1000;
+}
+
+static void init_pwm_pin(uint pin, uint16_t wrap, float clkdiv) {
+    uint slice = pwm_gpio_to_slice_num(pin);
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    pwm_set_clkdiv(slice, clkdiv);
+    pwm_set_wrap(slice, wrap);
+    pwm_set_gpio_level(pin, 0);
+    pwm_set_enabled(slice, true);
+}
+
+void seq_init(sequencer_t *s, uint buzzer_pin, uint red_pin, uint green_pin, uint blue_pin,
+              alarm_pool_t *pool) {
+    *s = (sequencer_t){
+        .buzzer_pin = buzzer_pin,
+        .rgb_pins = { red_pin, green_pin, blue_pin },
+        .pool = pool,
+    };
+    init_pwm_pin(buzzer_pin, 0, (float)clock_get_hz(clk_sys) / BUZZER_TICK_HZ);
+    for (int i = 0; i < 3; i++) {
+        init_pwm_pin(s->rgb_pins[i], LED_WRAP, 1.0f);  // ~490 kHz: sem cintilação
+    }
+}
+
+bool seq_play(sequencer_t *s, const seq_step_t *steps, uint8_t count) {
+    uint32_t irq = save_and_disable_interrupts();
+    bool ok = count && s->count < SEQ_QUEUE_SIZE;
+
+    if (!ok) {
+        s->dropped++;
+    } else {
+        s->queue[(s->head + s->count) % SEQ_QUEUE_SIZE] = (seq_pattern_t){ steps, count };
+        if (s->count++ == 0) {
+            s->step = 0;
+            apply_step(s);
+            if (alarm_pool_add_alarm_in_ms(s->pool, steps[0].ms, step_callback, s, true) < 0) {
+                s->count = 0;  // Pool sem alarmes livres: desiste em vez de travar o tom
+                set_tone(s, 0);
+                set_led(s, s->background);
+                ok = false;
+            }
+        }
+    }
+    restore_interrupts(irq);
+    return ok;
+}
+
+void seq_background(sequencer_t *s, uint8_t r, uint8_t g, uint8_t b) {
+    uint32_t irq = save_and_disable_interrupts();
+    s->background[0] = r;
+    s->background[1] = g;
+    s->background[2] = b;
+    if (!s->count || !current_step(s)->led) {
+        set_led(s, s->background);
+    }
+    restore_interrupts(irq);
+}
@@ -0,0 +1,48 @@
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+#define SEQ_QUEUE_SIZE 4
+
+// Um passo de padrão: tom no buzzer e, com led, uma cor por cima da de fundo
+typedef struct {
+    uint16_t tone_hz;                    // 0: buzzer mudo
+    uint16_t ms;                         // Duração (> 0)
+    bool led;                            // false: LED fica na cor de fundo
+    uint8_t r, g, b;                     // Brilho 0-255
+} seq_step_t;
+
+typedef struct {
+    const seq_step_t *steps;
+    uint8_t count;
+} seq_pattern_t;
+
+// Buzzer e LED RGB por PWM. Os padrões tocam em fila, um após o outro; cada
+// passo é avançado por um alarme, então quem toca nunca espera. Ao esvaziar
+// a fila o buzzer cala e o LED volta à cor de fundo. Usar de um só núcleo
+// (o dono do pool).
+typedef struct {
+    uint buzzer_pin;
+    uint rgb_pins[3];
+    alarm_pool_t *pool;
+    seq_pattern_t queue[SEQ_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    uint8_t step;                        // Passo atual de queue[head]
+    uint8_t background[3];
+    uint32_t dropped;                    // Padrões recusados com a fila cheia
+} sequencer_t;
+
+void seq_init(sequencer_t *s, uint buzzer_pin, uint red_pin, uint green_pin, uint blue_pin,
+              alarm_pool_t *pool);
+
+// Enfileira um padrão (steps precisa continuar válido até tocar); false se cheia
+bool seq_play(sequencer_t *s, const seq_step_t *steps, uint8_t count);
+
+// Cor do LED fora dos padrões
+void seq_background(sequencer_t *s, uint8_t r, uint8_t g, uint8_t b);
+
+#endif
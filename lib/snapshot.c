@@ -0,0 +1,24 @@
+#include <string.h>
+#include "snapshot.h"
+
+void snapshot_write(snapshot_t *s, const void *value) {
+    uint32_t seq = s->seq;
+
+    // Leitores passam para a cópia 1 enquanto a 0 é escrita, e depois voltam
+    __atomic_store_n(&s->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(s->copies, value, s->size);
+    __atomic_store_n(&s->seq, seq + 2, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(s->copies + s->size, value, s->size);
+}
+
+uint32_t snapshot_read(const snapshot_t *s, void *value) {
+    uint32_t seq;
+    do {
+        seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+        memcpy(value, s->copies + (seq & 1) * s->size, s->size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&s->seq, __ATOMIC_RELAXED) != seq);
+    return seq >> 1;
+}
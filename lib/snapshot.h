@@ -0,0 +1,33 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Valor publicado por um único escritor e lido por qualquer núcleo ou
+// interrupção sem trava (seqlock com duas cópias, o "latch"). O escritor
+// nunca espera: atualiza uma cópia enquanto os leitores usam a outra. O
+// leitor repete só se o escritor de outro núcleo trocou as duas cópias
+// durante a leitura; uma interrupção que lê no meio de uma escrita do
+// próprio núcleo pega a cópia estável e nunca fica presa.
+typedef struct {
+    volatile uint32_t seq;               // Par: cópia 0 é a atual; ímpar: cópia 1
+    uint8_t *copies;                     // Duas cópias de size bytes
+    uint16_t size;
+} snapshot_t;
+
+// storage é um array de 2 elementos do tipo publicado
+#define SNAPSHOT_INIT(storage) \
+    { .copies = (uint8_t *)(storage), .size = sizeof((storage)[0]) }
+
+void snapshot_write(snapshot_t *s, const void *value);
+
+// Copia um valor consistente e retorna sua versão (número de escritas)
+uint32_t snapshot_read(const snapshot_t *s, void *value);
+
+// Versão atual, para saber se vale a pena ler de novo
+static inline uint32_t snapshot_version(const snapshot_t *s) {
+    return __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) >> 1;
+}
+
+#endif
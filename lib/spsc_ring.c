@@ -0,0 +1,29 @@
+#include <string.h>
+#include "spsc_ring.h"
+
+// As barreiras de acquire/release garantem que o item copiado fica visível
+// para o outro núcleo antes do índice que o publica (e vice-versa)
+bool spsc_ring_push(spsc_ring_t *r, const void *item) {
+    uint32_t head = r->head;
+    uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= r->capacity) {
+        r->dropped++;
+        return false;
+    }
+    memcpy(r->items + (head & (r->capacity - 1)) * r->item_size, item, r->item_size);
+    __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *r, void *item) {
+    uint32_t tail = r->tail;
+    uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+        return false;
+    }
+    memcpy(item, r->items + (tail & (r->capacity - 1)) * r->item_size, r->item_size);
+    __atomic_store_n(&r->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
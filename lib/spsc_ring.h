@@ -0,0 +1,29 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fila sem trava para um produtor e um consumidor (um em cada núcleo).
+// Só o produtor escreve head e só o consumidor escreve tail; os itens são
+// copiados inteiros, então cada lado vê um item completo ou nenhum.
+typedef struct {
+    uint8_t *items;
+    uint16_t item_size;
+    uint16_t capacity;                   // Potência de 2
+    volatile uint32_t head;              // Próximo a escrever (produtor)
+    volatile uint32_t tail;              // Próximo a ler (consumidor)
+    volatile uint32_t dropped;           // Pushes recusados com a fila cheia (produtor)
+} spsc_ring_t;
+
+#define SPSC_RING_INIT(storage) \
+    { .items = (uint8_t *)(storage), .item_size = sizeof((storage)[0]), \
+      .capacity = sizeof(storage) / sizeof((storage)[0]) }
+
+// Copia o item para a fila; false (e conta em dropped) se estiver cheia
+bool spsc_ring_push(spsc_ring_t *r, const void *item);
+
+// Copia o item mais antigo para fora da fila; false se estiver vazia
+bool spsc_ring_pop(spsc_ring_t *r, void *item);
+
+#endif
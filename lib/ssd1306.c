@@ -1,5 +1,18 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
+#include "font_large.h"
+#include "hardware/dma.h"
+
+const ssd1306_font_t ssd1306_font_8x8 = {
+  .glyphs = font, .width = 8, .height = 8, .first = ' ', .last = '~'
+};
+
+// Gerada em tempo de build por tools/gen_font.py
+const ssd1306_font_t ssd1306_font_16x24 = {
+  .glyphs = font_large, .width = FONT_LARGE_WIDTH, .height = FONT_LARGE_HEIGHT,
+  .first = FONT_LARGE_FIRST, .last = FONT_LARGE_LAST
+};
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
@@ -11,6 +24,24 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+
+  // O DMA alimenta a FIFO de TX do I2C com palavras de IC_DATA_CMD.
+  // Pior caso: uma janela por página (comandos + controle + colunas).
+  ssd->dma_buffer = calloc(ssd->pages * (SSD1306_DMA_PREFIX + 1 + ssd->width), sizeof(uint16_t));
+  ssd->dma_len = 0;
+  ssd->shadow = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->shadow_valid = false;
+  ssd->bytes_last_frame = 0;
+  ssd->bytes_total = 0;
+  ssd->frames = 0;
+  ssd->dma_channel = dma_claim_unused_channel(true);
+
+  dma_channel_config c = dma_channel_get_default_config(ssd->dma_channel);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+  dma_channel_configure(ssd->dma_channel, &c, &i2c_get_hw(i2c)->data_cmd, ssd->dma_buffer, 0, false);
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
@@ -42,6 +73,10 @@ void ssd1306_config(ssd1306_t *ssd) {
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  // Não pode intercalar com um quadro em transmissão pelo DMA
+  while (ssd1306_flush_busy(ssd))
+    tight_loop_contents();
+
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
     ssd->i2c_port,
@@ -52,20 +87,120 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
+bool ssd1306_flush_busy(ssd1306_t *ssd) {
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+
+  // NACK do display: a FIFO é descartada e o DMA ficaria parado para sempre
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    dma_channel_abort(ssd->dma_channel);
+    (void)hw->clr_tx_abrt;
+    ssd->shadow_valid = false;  // Não se sabe o que chegou ao painel
+    return false;
+  }
+
+  if (dma_channel_is_busy(ssd->dma_channel))
+    return true;
+
+  // DMA terminou, mas os últimos bytes ainda podem estar na FIFO/barramento
+  return !(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+// Força o próximo flush a reenviar a tela inteira
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->shadow_valid = false;
+}
+
+// Acrescenta ao fluxo DMA uma janela páginas [p0..p1] x colunas [c0..c1].
+// Em endereçamento vertical os bytes seguem a ordem coluna a coluna do ram_buffer.
+static uint16_t *ssd1306_emit_window(ssd1306_t *ssd, uint16_t *out, uint8_t p0, uint8_t p1, uint8_t c0, uint8_t c1) {
+  *out++ = 0x00;
+  *out++ = SET_COL_ADDR;
+  *out++ = c0;
+  *out++ = c1;
+  *out++ = SET_PAGE_ADDR;
+  *out++ = p0;
+  *out++ = p1 | I2C_IC_DATA_CMD_STOP_BITS;
+
+  *out++ = 0x40;
+  for (uint8_t c = c0; c <= c1; ++c) {
+    for (uint8_t p = p0; p <= p1; ++p) {
+      size_t i = 1 + p + c * ssd->pages;
+      *out++ = ssd->ram_buffer[i];
+      ssd->shadow[i] = ssd->ram_buffer[i];
+    }
+  }
+  out[-1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  return out;
+}
+
+// Inicia o envio das partes alteradas do quadro sem bloquear. Retorna false se
+// o quadro anterior ainda está em transmissão (ram_buffer pode continuar sendo desenhado).
+bool ssd1306_flush_async(ssd1306_t *ssd) {
+  if (ssd1306_flush_busy(ssd))
+    return false;
+
+  uint16_t *out = ssd->dma_buffer;
+  int win_p0 = -1, win_p1 = 0, win_c0 = 0, win_c1 = 0;
+
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    // Faixa de colunas desta página que difere do que o painel já tem
+    int c0 = -1, c1 = -1;
+    for (uint8_t c = 0; c < ssd->width; ++c) {
+      size_t i = 1 + p + c * ssd->pages;
+      if (!ssd->shadow_valid || ssd->ram_buffer[i] != ssd->shadow[i]) {
+        if (c0 < 0)
+          c0 = c;
+        c1 = c;
+      }
+    }
+    if (c0 < 0)
+      continue;
+
+    if (win_p0 >= 0) {
+      // Junta com a janela anterior se o retângulo unido custa menos bytes
+      int lo = MIN(win_c0, c0), hi = MAX(win_c1, c1);
+      int merged = 8 + (p - win_p0 + 1) * (hi - lo + 1);
+      int separate = 8 + (win_p1 - win_p0 + 1) * (win_c1 - win_c0 + 1) + 8 + (c1 - c0 + 1);
+      if (win_p1 == p - 1 && merged <= separate) {
+        win_p1 = p;
+        win_c0 = lo;
+        win_c1 = hi;
+        continue;
+      }
+      out = ssd1306_emit_window(ssd, out, win_p0, win_p1, win_c0, win_c1);
+    }
+    win_p0 = win_p1 = p;
+    win_c0 = c0;
+    win_c1 = c1;
+  }
+  if (win_p0 >= 0)
+    out = ssd1306_emit_window(ssd, out, win_p0, win_p1, win_c0, win_c1);
+
+  ssd->shadow_valid = true;
+  ssd->dma_len = out - ssd->dma_buffer;
+  ssd->bytes_last_frame = ssd->dma_len;
+  ssd->bytes_total += ssd->dma_len;
+  ssd->frames++;
+
+  // Nada mudou desde o último quadro
+  if (ssd->dma_len == 0)
+    return true;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+  hw->enable = 1;
+
+  dma_channel_transfer_from_buffer_now(ssd->dma_channel, ssd->dma_buffer, ssd->dma_len);
+  return true;
+}
+
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  while (!ssd1306_flush_async(ssd))
+    tight_loop_contents();
+  while (ssd1306_flush_busy(ssd))
+    tight_loop_contents();
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
@@ -77,24 +212,10 @@ void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
-
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
 }
 
-
-
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
   for (uint8_t x = left; x < left + width; ++x) {
     ssd1306_pixel(ssd, x, top, value);
@@ -153,48 +274,75 @@ void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value
     ssd1306_pixel(ssd, x, y, value);
 }
 
-// Função para desenhar um caractere
-void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+// Copia um glifo direto para o ram_buffer. Com y múltiplo de 8 cada byte da
+// fonte cai inteiro numa página; senão é dividido entre duas páginas vizinhas.
+void ssd1306_draw_glyph(ssd1306_t *ssd, const ssd1306_font_t *font, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
+  uint8_t glyph_pages = font->height / 8;
 
-  // Verifica o caractere e calcula o índice correspondente na fonte
-  if (c >= ' ' && c <= '~') // Verifica se o caractere está na faixa ASCII válida
-  {
-    index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
-  }
-  else
-  {
-    // Caractere inválido, desenha um espaço (ou pode ser tratado de outra forma)
-    index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
-  }
+  // Caractere fora da fonte desenha o primeiro glifo (espaço)
+  if (c < font->first || c > font->last)
+    c = font->first;
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
+  const uint8_t *src = font->glyphs + (size_t)(c - font->first) * font->width * glyph_pages;
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 0b111;
+  uint8_t mask_lo = (uint8_t)(0xFF << shift);
+  uint8_t mask_hi = (uint8_t)~mask_lo;
+
+  for (uint8_t i = 0; i < font->width; ++i, src += glyph_pages)
   {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
+    if (x + i >= ssd->width)
+      break;
+
+    uint8_t *column = ssd->ram_buffer + 1 + (x + i) * ssd->pages;
+    for (uint8_t k = 0; k < glyph_pages; ++k)
     {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
+      uint8_t p = page + k;
+      if (p >= ssd->pages)
+        break;
+
+      if (shift == 0)
+      {
+        column[p] = src[k];
+      }
+      else
+      {
+        column[p] = (column[p] & mask_hi) | (uint8_t)(src[k] << shift);
+        if (p + 1 < ssd->pages)
+          column[p + 1] = (column[p + 1] & mask_lo) | (src[k] >> (8 - shift));
+      }
     }
   }
 }
 
-// Função para desenhar uma string
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+// Função para desenhar um caractere
+void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  ssd1306_draw_glyph(ssd, &ssd1306_font_8x8, c, x, y);
+}
+
+// Função para desenhar uma string com uma fonte qualquer
+void ssd1306_draw_string_font(ssd1306_t *ssd, const ssd1306_font_t *font, const char *str, uint8_t x, uint8_t y)
 {
   while (*str)
   {
-    ssd1306_draw_char(ssd, *str++, x, y);
-    x += 8;
-    if (x + 8 >= ssd->width)
+    ssd1306_draw_glyph(ssd, font, *str++, x, y);
+    x += font->width;
+    if (x + font->width > ssd->width)
     {
       x = 0;
-      y += 8;
+      y += font->height;
     }
-    if (y + 8 >= ssd->height)
+    if (y + font->height > ssd->height)
     {
       break;
     }
   }
-}
\ No newline at end of file
+}
+
+// Função para desenhar uma string
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+  ssd1306_draw_string_font(ssd, &ssd1306_font_8x8, str, x, y);
+}
@@ -25,6 +25,9 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+// Comandos enviados antes de cada janela no fluxo DMA (controle + 6 bytes)
+#define SSD1306_DMA_PREFIX 7
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
@@ -32,12 +35,37 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  // Segundo buffer: quadro em transmissão no formato IC_DATA_CMD (16 bits)
+  uint16_t *dma_buffer;
+  size_t dma_len;
+  int dma_channel;
+  // Cópia do que o painel recebeu por último, para enviar só as janelas alteradas
+  uint8_t *shadow;
+  bool shadow_valid;
+  // Bytes enviados pelo I2C (comandos + dados) no último quadro e no total
+  uint32_t bytes_last_frame;
+  uint32_t bytes_total;
+  uint32_t frames;
 } ssd1306_t;
 
+// Fonte no layout nativo do painel: coluna a coluna, com as height/8 páginas
+// de cada coluna em sequência (bit 0 = linha de cima)
+typedef struct {
+  const uint8_t *glyphs;
+  uint8_t width, height;
+  char first, last;
+} ssd1306_font_t;
+
+extern const ssd1306_font_t ssd1306_font_8x8;
+extern const ssd1306_font_t ssd1306_font_16x24;
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+bool ssd1306_flush_async(ssd1306_t *ssd);
+bool ssd1306_flush_busy(ssd1306_t *ssd);
+void ssd1306_invalidate(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -46,4 +74,6 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+void ssd1306_draw_glyph(ssd1306_t *ssd, const ssd1306_font_t *font, char c, uint8_t x, uint8_t y);
+void ssd1306_draw_string_font(ssd1306_t *ssd, const ssd1306_font_t *font, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
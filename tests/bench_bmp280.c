@@ -0,0 +1,187 @@
+// Compensação do BMP280: caminho antigo (t_fine calculado em
+// bmp280_convert_temp e de novo em bmp280_convert_pressure, depois
+// dividido por 100.0) contra bmp280_compensate, nos vetores de referência
+// do datasheet (BST-BMP280-DS001, seção 3.12) e numa varredura da faixa.
+// Compilado também com BMP280_USE_64BIT_COMPENSATION.
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "bmp280.h"
+#include "bench.h"
+#include "check.h"
+
+// Só para ligar o driver; a compensação não acessa o barramento
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c, (void)addr, (void)src, (void)nostop;
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)i2c, (void)addr, (void)dst, (void)nostop;
+    return (int)len;
+}
+
+static const struct bmp280_calib_param datasheet = {
+    .dig_t1 = 27504, .dig_t2 = 26435, .dig_t3 = -1000,
+    .dig_p1 = 36477, .dig_p2 = -10685, .dig_p3 = 3024, .dig_p4 = 2855,
+    .dig_p5 = 140, .dig_p6 = -7, .dig_p7 = 15500, .dig_p8 = -14600, .dig_p9 = 6000
+};
+#define RAW_T 519888                     // 25,08 °C
+#define RAW_P 415148                     // 100653,27 Pa
+
+// Caminho antigo de lib/bmp280.c, como era chamado pelo laço principal
+static int32_t legacy_t_fine(int32_t temp, const struct bmp280_calib_param *params) {
+    int32_t var1, var2;
+    var1 = ((((temp >> 3) - ((int32_t)params->dig_t1 << 1))) * ((int32_t)params->dig_t2)) >> 11;
+    var2 = (((((temp >> 4) - ((int32_t)params->dig_t1)) * ((temp >> 4) - ((int32_t)params->dig_t1))) >> 12) * ((int32_t)params->dig_t3)) >> 14;
+    return var1 + var2;
+}
+
+static int32_t legacy_convert_temp(int32_t temp, const struct bmp280_calib_param *params) {
+    int32_t t_fine = legacy_t_fine(temp, params);
+    return (t_fine * 5 + 128) >> 8;
+}
+
+static int32_t legacy_convert_pressure(int32_t pressure, int32_t temp, const struct bmp280_calib_param *params) {
+    int32_t t_fine = legacy_t_fine(temp, params);
+
+    int32_t var1, var2;
+    uint32_t converted = 0.0;
+    var1 = (((int32_t)t_fine) >> 1) - (int32_t)64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)params->dig_p6);
+    var2 += ((var1 * ((int32_t)params->dig_p5)) << 1);
+    var2 = (var2 >> 2) + (((int32_t)params->dig_p4) << 16);
+    var1 = (((params->dig_p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t)params->dig_p2) * var1) >> 1)) >> 18;
+    var1 = ((((32768 + var1)) * ((int32_t)params->dig_p1)) >> 15);
+    if (var1 == 0) {
+        return 0;
+    }
+    converted = (((uint32_t)(((int32_t)1048576) - pressure) - (var2 >> 12))) * 3125;
+    if (converted < 0x80000000) {
+        converted = (converted << 1) / ((uint32_t)var1);
+    } else {
+        converted = (converted / (uint32_t)var1) * 2;
+    }
+    var1 = (((int32_t)params->dig_p9) * ((int32_t)(((converted >> 3) * (converted >> 3)) >> 13))) >> 12;
+    var2 = (((int32_t)(converted >> 2)) * ((int32_t)params->dig_p8)) >> 13;
+    converted = (uint32_t)((int32_t)converted + ((var1 + var2 + params->dig_p7) >> 4));
+    return converted;
+}
+
+// Compensação em double do datasheet (seção 8.1), só como referência
+static void reference_double(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param *c,
+                             double *temperature, double *pressure) {
+    double var1 = (raw_t / 16384.0 - c->dig_t1 / 1024.0) * c->dig_t2;
+    double var2 = (raw_t / 131072.0 - c->dig_t1 / 8192.0) * (raw_t / 131072.0 - c->dig_t1 / 8192.0) * c->dig_t3;
+    double t_fine = (int32_t)(var1 + var2);
+    *temperature = (var1 + var2) / 5120.0;
+
+    var1 = t_fine / 2.0 - 64000.0;
+    var2 = var1 * var1 * c->dig_p6 / 32768.0;
+    var2 = var2 + var1 * c->dig_p5 * 2.0;
+    var2 = var2 / 4.0 + c->dig_p4 * 65536.0;
+    var1 = (c->dig_p3 * var1 * var1 / 524288.0 + c->dig_p2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * c->dig_p1;
+    double p = 1048576.0 - raw_p;
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = c->dig_p9 * p * p / 2147483648.0;
+    var2 = p * c->dig_p8 / 32768.0;
+    *pressure = p + (var1 + var2 + c->dig_p7) / 16.0;
+}
+
+// Pressão esperada no vetor do datasheet e erro máximo contra o double.
+// O algoritmo de 32 bits trunca etapas intermediárias e dá 100656 Pa.
+#ifdef BMP280_USE_64BIT_COMPENSATION
+#define PATH_NAME "bmp280 (64 bits)"
+#define DATASHEET_PRESSURE 100653
+#define PRESSURE_TOLERANCE 1
+#else
+#define PATH_NAME "bmp280 (32 bits)"
+#define DATASHEET_PRESSURE 100656
+#define PRESSURE_TOLERANCE 8
+#endif
+
+static void test_datasheet_vector(void) {
+    struct bmp280_reading r;
+
+    bmp280_compensate(RAW_T, RAW_P, &datasheet, &r);
+    CHECK_EQ(r.temperature, 2508);
+    CHECK_EQ(r.pressure, DATASHEET_PRESSURE);
+    CHECK_EQ(legacy_convert_temp(RAW_T, &datasheet), 2508);
+    printf("datasheet: %ld centi-°C, %lu Pa (antigo: %ld Pa; double: 100653,27 Pa)\n",
+           (long)r.temperature, (unsigned long)r.pressure,
+           (long)legacy_convert_pressure(RAW_P, RAW_T, &datasheet));
+}
+
+// Varre temperatura de -40 a 85 °C e pressão de 300 a 1100 hPa em raw
+static void test_sweep(void) {
+    long checked = 0, differ = 0, worst_p = 0, worst_t = 0;
+
+    for (int32_t raw_t = 380000; raw_t <= 660000; raw_t += 997) {
+        for (int32_t raw_p = 150000; raw_p <= 720000; raw_p += 1009) {
+            struct bmp280_reading r;
+            double t, p;
+
+            bmp280_compensate(raw_t, raw_p, &datasheet, &r);
+            reference_double(raw_t, raw_p, &datasheet, &t, &p);
+            if (p < 30000.0 || p > 110000.0 || t < -40.0 || t > 85.0) {
+                continue;
+            }
+            checked++;
+
+            long dt = labs(r.temperature - (long)(t * 100.0 + (t < 0 ? -0.5 : 0.5)));
+            long dp = labs((long)r.pressure - (long)(p + 0.5));
+            worst_t = dt > worst_t ? dt : worst_t;
+            worst_p = dp > worst_p ? dp : worst_p;
+
+#ifndef BMP280_USE_64BIT_COMPENSATION
+            // No modo de 32 bits a saída é bit a bit a do caminho antigo
+            if (r.temperature != legacy_convert_temp(raw_t, &datasheet) ||
+                (int32_t)r.pressure != legacy_convert_pressure(raw_p, raw_t, &datasheet)) {
+                differ++;
+            }
+#endif
+        }
+    }
+    CHECK(checked > 50000);
+    CHECK_EQ(differ, 0);
+    CHECK(worst_t <= 1);
+    CHECK(worst_p <= PRESSURE_TOLERANCE);
+    printf("varredura: %ld amostras, erro máx. %ld centi-°C e %ld Pa contra double\n",
+           checked, worst_t, worst_p);
+}
+
+#define BENCH_ROUNDS 2000000
+
+static void bench(void) {
+    uint64_t start = bench_now_ns();
+    for (int32_t i = 0; i < BENCH_ROUNDS; i++) {
+        int32_t raw_t = RAW_T + (i & 1023), raw_p = RAW_P + (i & 4095);
+        // Como o laço principal fazia: duas compensações e divisão em float
+        float temperature = legacy_convert_temp(raw_t, &datasheet) / 100.0;
+        float pressure = legacy_convert_pressure(raw_p, raw_t, &datasheet) / 100.0;
+        bench_sink += (int64_t)(temperature + pressure);
+    }
+    uint64_t legacy = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (int32_t i = 0; i < BENCH_ROUNDS; i++) {
+        struct bmp280_reading r;
+        bmp280_compensate(RAW_T + (i & 1023), RAW_P + (i & 4095), &datasheet, &r);
+        bench_sink += r.temperature + (int64_t)r.pressure;
+    }
+    uint64_t current = bench_now_ns() - start;
+
+    printf("antigo: %.1f ns/amostra, bmp280_compensate: %.1f ns/amostra (%.2fx)\n",
+           (double)legacy / BENCH_ROUNDS, (double)current / BENCH_ROUNDS,
+           (double)legacy / (double)current);
+}
+
+int main(void) {
+    printf("%s\n", PATH_NAME);
+    test_datasheet_vector();
+    test_sweep();
+    bench();
+    return check_result(PATH_NAME);
+}
@@ -0,0 +1,150 @@
+// Grandezas derivadas em ponto fixo (derived.c) contra as mesmas fórmulas
+// em double com libm, na faixa inteira dos sensores: pressão de 300 a
+// 1100 hPa com três QNH, temperatura de -40 a 85 °C (passo de 0,05 °C) e
+// umidade de 0,01 a 100 %UR (passo de 0,01 abaixo de 1 %UR, 0,25 acima).
+// Reporta o erro máximo de cada grandeza e o tempo por amostra.
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "derived.h"
+#include "bench.h"
+#include "check.h"
+
+// ---------- Referências em double ----------
+
+static double altitude_ref(double pressure, double qnh) {
+    return 44330.0 * (1.0 - pow(pressure / qnh, 0.1903));     // m
+}
+
+static double magnus_gamma_ref(double t, double rh) {
+    return log(rh / 100.0) + 17.62 * t / (243.12 + t);
+}
+
+static double dew_point_ref(double t, double rh) {
+    double g = magnus_gamma_ref(t, rh);
+    return 243.12 * g / (17.62 - g);                            // °C
+}
+
+static double abs_humidity_ref(double t, double rh) {
+    double e = 6.112 * exp(magnus_gamma_ref(t, rh));            // hPa
+    return 216.7 * e / (t + 273.15);                            // g/m³
+}
+
+// Algoritmo do NWS: Steadman, e Rothfusz com os ajustes a partir de 80 °F
+static double heat_index_ref(double t, double rh) {
+    double f = t * 9.0 / 5.0 + 32.0;
+    double hi = 0.5 * (f + 61.0 + (f - 68.0) * 1.2 + rh * 0.094);
+
+    if ((hi + f) / 2.0 >= 80.0) {
+        hi = -42.379 + 2.04901523 * f + 10.14333127 * rh - 0.22475541 * f * rh
+            - 6.83783e-3 * f * f - 5.481717e-2 * rh * rh + 1.22874e-3 * f * f * rh
+            + 8.5282e-4 * f * rh * rh - 1.99e-6 * f * f * rh * rh;
+        if (rh < 13.0 && f >= 80.0 && f <= 112.0) {
+            hi -= (13.0 - rh) / 4.0 * sqrt((17.0 - fabs(f - 95.0)) / 17.0);
+        } else if (rh > 85.0 && f >= 80.0 && f <= 87.0) {
+            hi += (rh - 85.0) / 10.0 * ((87.0 - f) / 5.0);
+        }
+    }
+    return (hi - 32.0) * 5.0 / 9.0;                             // °C
+}
+
+// Perto de uma fronteira descontínua dos ramos do NWS (a média de Steadman
+// em 80 °F, ou f = 80 °F nos ajustes) a própria referência salta; ali o
+// ponto fixo pode decidir pelo outro ramo
+static bool heat_index_at_jump(double t, double rh) {
+    double f = t * 9.0 / 5.0 + 32.0;
+    double hi = 0.5 * (f + 61.0 + (f - 68.0) * 1.2 + rh * 0.094);
+    return fabs((hi + f) / 2.0 - 80.0) < 1e-3 || fabs(f - 80.0) < 1e-3;
+}
+
+// ---------- Precisão ----------
+
+static void test_altitude(void) {
+    static const int32_t qnh[] = { 95000, DERIVED_QNH_DEFAULT, 105000 };
+
+    for (size_t q = 0; q < sizeof(qnh) / sizeof(qnh[0]); q++) {
+        double worst = 0;
+        for (int32_t p = 30000; p <= 110000; p++) {
+            double err = fabs(derived_altitude(p, qnh[q]) / 100.0 - altitude_ref(p, qnh[q]));
+            worst = err > worst ? err : worst;
+        }
+        printf("altitude (QNH %6.2f hPa): erro máximo %.3f m\n", qnh[q] / 100.0, worst);
+        CHECK(worst < 0.1);
+    }
+    CHECK_EQ(derived_altitude(DERIVED_QNH_DEFAULT, DERIVED_QNH_DEFAULT), 0);
+}
+
+typedef struct {
+    double worst, at_t, at_rh;
+} worst_t;
+
+static void track(worst_t *w, double err, int32_t t, int32_t rh) {
+    if (err > w->worst) {
+        *w = (worst_t){ err, t / 100.0, rh / 100.0 };
+    }
+}
+
+static void test_humidity(void) {
+    worst_t dew = { 0 }, ah = { 0 }, heat = { 0 };
+    int jumps = 0;
+
+    for (int32_t t = -4000; t <= 8500; t += 5) {
+        for (int32_t rh = 1; rh <= 10000; rh += rh < 100 ? 1 : 25) {
+            double tc = t / 100.0, r = rh / 100.0;
+            track(&dew, fabs(derived_dew_point(t, rh) / 100.0 - dew_point_ref(tc, r)), t, rh);
+            track(&ah, fabs(derived_abs_humidity(t, rh) / 100.0 - abs_humidity_ref(tc, r)), t, rh);
+
+            if (heat_index_at_jump(tc, r)) {
+                jumps++;
+                continue;
+            }
+            track(&heat, fabs(derived_heat_index(t, rh) / 100.0 - heat_index_ref(tc, r)), t, rh);
+        }
+    }
+    printf("ponto de orvalho: erro máximo %.4f °C (%.2f °C, %.2f %%UR)\n", dew.worst, dew.at_t, dew.at_rh);
+    printf("umidade absoluta: erro máximo %.4f g/m³ (%.2f °C, %.2f %%UR)\n", ah.worst, ah.at_t, ah.at_rh);
+    printf("índice de calor: erro máximo %.4f °C (%.2f °C, %.2f %%UR), %d pontos ignorados nos saltos\n",
+           heat.worst, heat.at_t, heat.at_rh, jumps);
+    CHECK(dew.worst < 0.01);
+    CHECK(ah.worst < 0.02);
+    CHECK(heat.worst < 0.01);
+    CHECK(jumps < 100);
+}
+
+// ---------- Tempo por amostra ----------
+
+static void measure(void) {
+    enum { ROUNDS = 200000 };
+    measurement_t m = { 0 };
+    double sink = 0;
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < ROUNDS; i++) {
+        m.temperature = -4000 + i % 12500;
+        m.humidity = 1 + i % 9999;
+        m.pressure = 30000 + i % 80000;
+        derived_compute(&m, DERIVED_QNH_DEFAULT);
+        bench_sink += m.altitude + m.dew_point + m.abs_humidity + m.heat_index;
+    }
+    uint64_t fixed_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (int i = 0; i < ROUNDS; i++) {
+        double t = (-4000 + i % 12500) / 100.0, rh = (1 + i % 9999) / 100.0;
+        sink += altitude_ref(30000 + i % 80000, DERIVED_QNH_DEFAULT) + dew_point_ref(t, rh) +
+                abs_humidity_ref(t, rh) + heat_index_ref(t, rh);
+    }
+    uint64_t libm_ns = bench_now_ns() - start;
+    bench_sink += (int64_t)sink;
+
+    // No host o double é de hardware; no RP2040 o libm é emulado em software
+    printf("por amostra: derived_compute %.1f ns, libm (double, FPU do host) %.1f ns\n",
+           (double)fixed_ns / ROUNDS, (double)libm_ns / ROUNDS);
+}
+
+int main(void) {
+    test_altitude();
+    test_humidity();
+    measure();
+    return check_result("derived");
+}
@@ -0,0 +1,273 @@
+// Parser HTTP incremental: cada requisição é reprocessada partida em todos os
+// pontos possíveis, em segmentos de tamanho fixo e byte a byte, e várias
+// requisições em pipeline são entregues coladas em segmentos aleatórios. O
+// resultado tem de ser sempre o da requisição inteira num só pedaço. Depois
+// mede a vazão do parser com requisições típicas do painel.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "http_parser.h"
+#include "bench.h"
+#include "check.h"
+
+#define MAX_SEGMENT 1460                 // MSS típico
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef struct {
+    http_parse_status_t status;
+    http_parse_error_t error;
+    size_t used;                         // Bytes consumidos até DONE ou erro
+    http_parser_t fields;
+} result_t;
+
+// Só os campos públicos; o estado interno pode diferir sem problema
+static bool same_result(const result_t *a, const result_t *b) {
+    const http_parser_t *x = &a->fields, *y = &b->fields;
+    if (a->status != b->status || a->error != b->error || a->used != b->used) {
+        return false;
+    }
+    if (a->status != HTTP_PARSE_DONE) {
+        return true;
+    }
+    return x->method == y->method && strcmp(x->path, y->path) == 0 && strcmp(x->query, y->query) == 0 &&
+           x->http11 == y->http11 && x->conn_close == y->conn_close &&
+           x->conn_keep_alive == y->conn_keep_alive && strcmp(x->if_none_match, y->if_none_match) == 0 &&
+           x->content_length == y->content_length && memcmp(x->body, y->body, x->content_length) == 0;
+}
+
+// Alimenta a requisição em segmentos com os tamanhos dados (o último se
+// repete) e para no fim da requisição ou no erro
+static result_t parse_segments(const char *text, size_t len, const size_t *sizes, int count) {
+    http_parser_t p;
+    size_t off = 0;
+    int i = 0;
+
+    http_parser_reset(&p);
+    while (off < len && http_parser_status(&p) == HTTP_PARSE_INCOMPLETE) {
+        size_t n = sizes[i < count ? i : count - 1];
+        if (n > len - off) {
+            n = len - off;
+        }
+        size_t used = http_parser_feed(&p, text + off, n);
+        off += used;
+        i++;
+        if (used < n) {
+            break;
+        }
+    }
+    return (result_t){ http_parser_status(&p), p.error, off, p };
+}
+
+static result_t parse_whole(const char *text) {
+    size_t len = strlen(text);
+    return parse_segments(text, len, &len, 1);
+}
+
+// ---------- Casos ----------
+
+#define LONG_VALUE "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36"
+
+static const char *const valid[] = {
+    "GET /api/data?since=120 HTTP/1.1\r\nHost: estacao\r\nAccept: */*\r\nIf-None-Match: \"a1b2c3\"\r\n\r\n",
+    "POST /api/config HTTP/1.1\r\nHost: estacao\r\nContent-Type: application/json\r\n"
+    "Connection: keep-alive\r\nContent-Length: 19\r\n\r\n{\"temp_max\": 31.50}",
+    "GET /app.js HTTP/1.0\nConnection: Keep-Alive\n\n",
+    "GET / HTTP/1.1\r\nUser-Agent: " LONG_VALUE "\r\nConnection: close\r\n\r\n",
+    "DELETE /api/config HTTP/1.1\r\nContent-Length:   3  \r\n\r\nabc",
+};
+
+static char long_headers[HTTP_PARSER_MAX_HEADER + 64];
+
+static const struct {
+    const char *text;
+    http_parse_error_t error;
+} invalid[] = {
+    { "GET /api/" "01234567890123456789012345678901234567890123" " HTTP/1.1\r\n\r\n", HTTP_PARSE_URI_TOO_LONG },
+    { "GET /api/data?" "since=0123456789012345678901234567" " HTTP/1.1\r\n\r\n", HTTP_PARSE_URI_TOO_LONG },
+    { long_headers, HTTP_PARSE_HEADERS_TOO_LARGE },
+    { "POST /api/config HTTP/1.1\r\nContent-Length: 385\r\n\r\n", HTTP_PARSE_BODY_TOO_LARGE },
+    { "POST /api/config HTTP/1.1\r\nContent-Length: 1x\r\n\r\n", HTTP_PARSE_BAD_REQUEST },
+    { "GET / HTTP/1.1\r\nHost estacao\r\n\r\n", HTTP_PARSE_BAD_REQUEST },
+    { "GET / HTTP/2.0\r\n\r\n", HTTP_PARSE_BAD_REQUEST },
+    { "GARBAGE\r\n\r\n", HTTP_PARSE_BAD_REQUEST },
+    { "GET /\r\n\r\n", HTTP_PARSE_BAD_REQUEST },
+};
+
+static void make_long_headers(void) {
+    char *out = long_headers;
+    out += sprintf(out, "GET / HTTP/1.1\r\n");
+    while (out - long_headers < HTTP_PARSER_MAX_HEADER) {
+        out += sprintf(out, "X-Pad: %.40s\r\n", LONG_VALUE);
+    }
+    sprintf(out, "\r\n");
+}
+
+static void test_reference(void) {
+    result_t r = parse_whole(valid[0]);
+    CHECK_EQ(r.status, HTTP_PARSE_DONE);
+    CHECK_EQ(r.fields.method, HTTP_METHOD_GET);
+    CHECK(strcmp(r.fields.path, "/api/data") == 0);
+    CHECK(strcmp(r.fields.query, "since=120") == 0);
+    CHECK(strcmp(r.fields.if_none_match, "\"a1b2c3\"") == 0);
+    CHECK(http_parser_keep_alive(&r.fields));
+
+    r = parse_whole(valid[1]);
+    CHECK_EQ(r.status, HTTP_PARSE_DONE);
+    CHECK_EQ(r.fields.method, HTTP_METHOD_POST);
+    CHECK_EQ(r.fields.content_length, 19);
+    CHECK(strcmp(r.fields.body, "{\"temp_max\": 31.50}") == 0);
+
+    r = parse_whole(valid[2]);
+    CHECK(!r.fields.http11 && http_parser_keep_alive(&r.fields));
+
+    // Valor longo de cabeçalho ignorado não atrapalha os seguintes
+    r = parse_whole(valid[3]);
+    CHECK_EQ(r.status, HTTP_PARSE_DONE);
+    CHECK(!http_parser_keep_alive(&r.fields));
+
+    r = parse_whole(valid[4]);
+    CHECK_EQ(r.fields.method, HTTP_METHOD_OTHER);
+    CHECK(strcmp(r.fields.body, "abc") == 0);
+
+    for (size_t i = 0; i < count_of(invalid); i++) {
+        r = parse_whole(invalid[i].text);
+        CHECK_EQ(r.status, HTTP_PARSE_ERROR);
+        CHECK_EQ(r.error, invalid[i].error);
+    }
+}
+
+// Todo ponto de corte em dois pedaços e todos os tamanhos fixos de segmento,
+// de 1 byte (byte a byte) até a requisição inteira
+static int replay_splits(const char *text) {
+    size_t len = strlen(text);
+    result_t whole = parse_whole(text);
+    int mismatches = 0;
+
+    for (size_t cut = 1; cut < len; cut++) {
+        size_t sizes[2] = { cut, len - cut };
+        result_t r = parse_segments(text, len, sizes, 2);
+        mismatches += !same_result(&r, &whole);
+    }
+    for (size_t seg = 1; seg <= len; seg++) {
+        result_t r = parse_segments(text, len, &seg, 1);
+        mismatches += !same_result(&r, &whole);
+    }
+    return mismatches;
+}
+
+static void test_split(void) {
+    for (size_t i = 0; i < count_of(valid); i++) {
+        CHECK_EQ(replay_splits(valid[i]), 0);
+    }
+    for (size_t i = 0; i < count_of(invalid); i++) {
+        CHECK_EQ(replay_splits(invalid[i].text), 0);
+    }
+}
+
+// Todas as requisições válidas coladas num fluxo, como chegam em pipeline,
+// entregues em segmentos aleatórios que cruzam os limites entre elas
+static void test_pipelined(void) {
+    char stream[2048];
+    result_t expected[count_of(valid)];
+    size_t len = 0;
+    uint32_t seed = 2024;
+    int mismatches = 0, incomplete = 0;
+
+    for (size_t i = 0; i < count_of(valid); i++) {
+        expected[i] = parse_whole(valid[i]);
+        memcpy(stream + len, valid[i], strlen(valid[i]));
+        len += strlen(valid[i]);
+    }
+
+    for (int round = 0; round < 2000; round++) {
+        http_parser_t p;
+        size_t done = 0, off = 0, start = 0;
+        int max_seg = round < 1000 ? 16 : 512;
+
+        http_parser_reset(&p);
+        while (off < len) {
+            seed = seed * 1103515245u + 12345u;
+            size_t n = 1 + (seed >> 16) % (uint32_t)max_seg;
+            if (n > len - off) {
+                n = len - off;
+            }
+            // Um segmento pode terminar uma requisição e começar a próxima
+            const char *seg = stream + off;
+            while (n) {
+                size_t used = http_parser_feed(&p, seg, n);
+                seg += used;
+                n -= used;
+                off += used;
+                if (http_parser_status(&p) != HTTP_PARSE_DONE) {
+                    break;
+                }
+                result_t r = { HTTP_PARSE_DONE, p.error, off - start, p };
+                mismatches += done >= count_of(valid) || !same_result(&r, &expected[done]);
+                done++;
+                start = off;
+                http_parser_reset(&p);
+            }
+        }
+        incomplete += done != count_of(valid) || http_parser_status(&p) != HTTP_PARSE_INCOMPLETE || p.header_bytes;
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(incomplete, 0);
+}
+
+// ---------- Vazão ----------
+
+static const char dashboard_get[] =
+    "GET /api/data?since=4821 HTTP/1.1\r\n"
+    "Host: 192.168.0.42\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: " LONG_VALUE "\r\n"
+    "Accept: */*\r\n"
+    "Referer: http://192.168.0.42/\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: pt-BR,pt;q=0.9,en-US;q=0.8,en;q=0.7\r\n"
+    "If-None-Match: \"3f2a91c0\"\r\n"
+    "\r\n";
+
+static const char config_post[] =
+    "POST /api/config HTTP/1.1\r\n"
+    "Host: 192.168.0.42\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: 89\r\n"
+    "\r\n"
+    "{\"temp_min\":10.00,\"temp_max\":35.00,\"hum_min\":20.00,\"hum_max\":80.00,\"press_offset\":0.00}  ";
+
+static void measure(const char *name, const char *text, size_t seg, int rounds) {
+    size_t len = strlen(text);
+    http_parser_t p;
+
+    CHECK_EQ(parse_segments(text, len, &seg, 1).status, HTTP_PARSE_DONE);
+
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        http_parser_reset(&p);
+        for (size_t off = 0; off < len; off += seg) {
+            http_parser_feed(&p, text + off, len - off < seg ? len - off : seg);
+        }
+        bench_sink += p.state;
+    }
+    uint64_t ns = bench_now_ns() - start;
+
+    printf("%-12s %4zu bytes, segmentos de %4zu: %6.0f ns/req, %6.1f MB/s\n", name, len, seg,
+           (double)ns / rounds, (double)len * rounds * 1000.0 / (double)ns);
+}
+
+int main(void) {
+    make_long_headers();
+    test_reference();
+    test_split();
+    test_pipelined();
+
+    static const size_t segments[] = { MAX_SEGMENT, 64, 1 };
+    for (size_t i = 0; i < count_of(segments); i++) {
+        measure("GET painel", dashboard_get, segments[i], 200000);
+    }
+    for (size_t i = 0; i < count_of(segments); i++) {
+        measure("POST config", config_post, segments[i], 200000);
+    }
+    return check_result("http_parser");
+}
@@ -0,0 +1,174 @@
+// Corpo de /api/data com 50 e 500 pontos: o código antigo (sprintf "%.1f"
+// de float, strcat em três strings de histórico, snprintf do JSON e cópia
+// para a resposta) contra json_writer numa passada, em ponto fixo. As duas
+// saídas são conferidas byte a byte antes de medir.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "json_writer.h"
+#include "bench.h"
+#include "check.h"
+
+typedef struct {
+    int32_t temperature, humidity, pressure, altitude;   // Centésimos
+    int32_t *history[3];                                  // Centésimos, passo de 0,1
+    int count;
+} data_t;
+
+// ---------- Caminho antigo (Trabalho_SE_11.c original) ----------
+
+// Os buffers originais tinham 512 bytes por série e 2 KB no JSON: com 500
+// pontos nem cabiam. Aqui crescem com count para a medição ser possível.
+static size_t legacy_format(const data_t *d, char *response, size_t cap,
+                            char *hist[3], size_t hist_cap, char *json, size_t json_cap) {
+    float history[3][500];
+    for (int s = 0; s < 3; s++) {
+        for (int i = 0; i < d->count; i++) {
+            history[s][i] = d->history[s][i] / 100.0f;
+        }
+    }
+
+    for (int s = 0; s < 3; s++) {
+        strcpy(hist[s], "[");
+    }
+    for (int i = 0; i < d->count; i++) {
+        char val[16];
+        for (int s = 0; s < 3; s++) {
+            sprintf(val, "%.1f%s", history[s][i], (i < d->count - 1) ? "," : "");
+            strcat(hist[s], val);
+        }
+    }
+    for (int s = 0; s < 3; s++) {
+        strcat(hist[s], "]");
+    }
+    (void)hist_cap;
+
+    snprintf(json, json_cap,
+        "{"
+        "\"temperature\":%.2f,"
+        "\"humidity\":%.2f,"
+        "\"pressure\":%.2f,"
+        "\"altitude\":%.2f,"
+        "\"history\":{"
+        "\"temperature\":%s,"
+        "\"humidity\":%s,"
+        "\"pressure\":%s"
+        "}"
+        "}",
+        d->temperature / 100.0f, d->humidity / 100.0f, d->pressure / 100.0f, d->altitude / 100.0f,
+        hist[0], hist[1], hist[2]);
+
+    return (size_t)snprintf(response, cap, "%s", json);
+}
+
+// ---------- json_writer ----------
+
+static int32_t div10(int32_t v) {
+    return (v < 0 ? v - 5 : v + 5) / 10;
+}
+
+static size_t writer_format(const data_t *d, char *response, size_t cap) {
+    static const char *const names[3] = { "temperature", "humidity", "pressure" };
+    json_writer_t w;
+
+    json_init(&w, response, cap);
+    json_object_begin(&w);
+    json_key(&w, "temperature");
+    json_fixed(&w, d->temperature, 2);
+    json_key(&w, "humidity");
+    json_fixed(&w, d->humidity, 2);
+    json_key(&w, "pressure");
+    json_fixed(&w, d->pressure, 2);
+    json_key(&w, "altitude");
+    json_fixed(&w, d->altitude, 2);
+    json_key(&w, "history");
+    json_object_begin(&w);
+    for (int s = 0; s < 3; s++) {
+        json_key(&w, names[s]);
+        json_array_begin(&w);
+        for (int i = 0; i < d->count; i++) {
+            json_fixed(&w, div10(d->history[s][i]), 1);
+        }
+        json_array_end(&w);
+    }
+    json_object_end(&w);
+    json_object_end(&w);
+    return json_ok(&w) ? w.len : 0;
+}
+
+// Série suave com ruído, em passos de 0,1 como o histórico exibido
+static void make_data(data_t *d, int count) {
+    static const int32_t base[3] = { 2350, 6120, 101325 };
+    static const int32_t swing[3] = { 400, 1500, 300 };
+    uint32_t seed = 12345;
+
+    d->count = count;
+    d->temperature = 2534;
+    d->humidity = 6187;
+    d->pressure = 101298;
+    d->altitude = 2255;
+    for (int s = 0; s < 3; s++) {
+        d->history[s] = malloc(sizeof(int32_t) * (size_t)count);
+        for (int i = 0; i < count; i++) {
+            seed = seed * 1103515245u + 12345u;
+            int32_t v = base[s] + swing[s] * ((i * 7) % 100 - 50) / 50 + (int32_t)((seed >> 16) % 50) - 25;
+            d->history[s][i] = v / 10 * 10;
+        }
+    }
+}
+
+static void free_data(data_t *d) {
+    for (int s = 0; s < 3; s++) {
+        free(d->history[s]);
+    }
+}
+
+static void run(int count, int rounds) {
+    data_t d;
+    size_t hist_cap = (size_t)count * 16 + 4, json_cap = 3 * hist_cap + 256;
+    char *hist[3] = { malloc(hist_cap), malloc(hist_cap), malloc(hist_cap) };
+    char *json = malloc(json_cap);
+    char *legacy = malloc(json_cap);
+    char *fresh = malloc(json_cap);
+
+    make_data(&d, count);
+
+    size_t legacy_len = legacy_format(&d, legacy, json_cap, hist, hist_cap, json, json_cap);
+    size_t len = writer_format(&d, fresh, json_cap);
+    CHECK_EQ(len, legacy_len);
+    CHECK(len == legacy_len && memcmp(fresh, legacy, len) == 0);
+
+    // Sem espaço: falha limpa, sem escrever além do buffer
+    memset(fresh, '#', json_cap);
+    CHECK_EQ(writer_format(&d, fresh, len - 1), 0);
+    CHECK(fresh[len - 1] == '#');
+
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        bench_sink += (int64_t)legacy_format(&d, legacy, json_cap, hist, hist_cap, json, json_cap);
+    }
+    uint64_t old_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        bench_sink += (int64_t)writer_format(&d, fresh, json_cap);
+    }
+    uint64_t new_ns = bench_now_ns() - start;
+
+    printf("%3d pontos (%zu bytes): sprintf/strcat %8.0f ns, json_writer %7.0f ns (%.1fx)\n",
+           count, len, (double)old_ns / rounds, (double)new_ns / rounds, (double)old_ns / (double)new_ns);
+
+    free_data(&d);
+    for (int s = 0; s < 3; s++) {
+        free(hist[s]);
+    }
+    free(json);
+    free(legacy);
+    free(fresh);
+}
+
+int main(void) {
+    run(50, 20000);
+    run(500, 500);
+    return check_result("json_writer");
+}
@@ -0,0 +1,185 @@
+// Histórico comprimido (sample_store): taxa de compressão e custo de
+// codificar e decodificar por amostra. Não há gravação real da estação no
+// repositório, então os traços são sintéticos, nas unidades de
+// add_to_history (centésimos de °C e %, décimos de hPa, uma amostra por
+// segundo): um dia sem ruído (limite superior), um calmo com ruído de
+// poucos LSB e um com ruído forte e frentes, o pior caso para a previsão.
+// Todo traço é decodificado e conferido, e os bytes por amostra não podem
+// passar dos números citados no README.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sample_store.h"
+#include "bench.h"
+#include "check.h"
+
+#define DAY_S (24 * 60 * 60)
+#define BLOCKS 2048                      // Cabe um dia inteiro, sem descarte
+#define FLOAT_BYTES (3 * sizeof(float))  // Amostra no HistoricalData antigo
+
+typedef struct {
+    uint32_t *time;
+    int16_t (*values)[SAMPLE_STORE_CHANNELS];
+    int count;
+} trace_t;
+
+static uint32_t seed = 1;
+
+static int noise(int amplitude) {
+    seed = seed * 1103515245u + 12345u;
+    return amplitude ? (int)((seed >> 16) % (uint32_t)(2 * amplitude + 1)) - amplitude : 0;
+}
+
+// Ciclo diário de temperatura e umidade em oposição, pressão lenta. Um
+// segundo entre amostras, com atrasos ocasionais do laço principal.
+static void make_trace(trace_t *t, int count, int lsb_noise, bool fronts) {
+    uint32_t time_s = 1000;
+
+    t->count = count;
+    t->time = malloc(sizeof(*t->time) * (size_t)count);
+    t->values = malloc(sizeof(*t->values) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        double phase = 2.0 * M_PI * i / DAY_S;
+        double temperature = 2200 + 500 * sin(phase);
+        double humidity = 6500 - 1500 * sin(phase);
+        double pressure = 10132 + 15 * sin(phase / 2 + 1.0);
+        if (fronts && i % 7200 > 6000) {
+            temperature -= (i % 7200 - 6000) / 2.0;   // Queda brusca a cada duas horas
+            humidity += (i % 7200 - 6000);
+        }
+        t->time[i] = time_s;
+        t->values[i][0] = (int16_t)lround(temperature) + (int16_t)noise(lsb_noise);
+        t->values[i][1] = (int16_t)lround(humidity) + (int16_t)noise(lsb_noise * 2);
+        t->values[i][2] = (int16_t)lround(pressure) + (int16_t)noise(lsb_noise / 2);
+        time_s += noise(50) == 50 ? 2 : 1;
+    }
+}
+
+static void free_trace(trace_t *t) {
+    free(t->time);
+    free(t->values);
+}
+
+static void run(const char *name, const trace_t *t, double max_bytes) {
+    static sample_block_t blocks[BLOCKS];
+    sample_store_t s;
+    sample_cursor_t c;
+    uint32_t time_s;
+    int16_t values[SAMPLE_STORE_CHANNELS];
+    int mismatches = 0, decoded = 0;
+
+    sample_store_init(&s, blocks, BLOCKS);
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < t->count; i++) {
+        sample_store_append(&s, t->time[i], t->values[i]);
+    }
+    uint64_t encode_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    sample_store_begin(&s, &c);
+    while (sample_store_next(&s, &c, &time_s, values)) {
+        bench_sink += time_s + values[0];
+        decoded++;
+    }
+    uint64_t decode_ns = bench_now_ns() - start;
+
+    // Sem perda: cada amostra volta exatamente como entrou
+    sample_store_begin(&s, &c);
+    for (int i = 0; i < t->count && sample_store_next(&s, &c, &time_s, values); i++) {
+        mismatches += time_s != t->time[i] || memcmp(values, t->values[i], sizeof(values)) != 0;
+    }
+    CHECK_EQ(decoded, t->count);
+    CHECK_EQ(sample_store_count(&s), t->count);
+    CHECK_EQ(mismatches, 0);
+
+    double bytes = (double)sample_store_bytes(&s) / t->count;
+    printf("%-16s %6d amostras: %5.2f bytes/amostra (%4.1fx sobre 3 floats), "
+           "codifica %5.1f ns, decodifica %5.1f ns por amostra\n",
+           name, t->count, bytes, FLOAT_BYTES / bytes,
+           (double)encode_ns / t->count, (double)decode_ns / t->count);
+    CHECK(bytes <= max_bytes);
+}
+
+// Anel cheio: descarta blocos inteiros, e um cursor antigo pula para o mais
+// antigo ainda guardado sem decodificar lixo
+static void test_wrap(const trace_t *t) {
+    sample_block_t blocks[4];
+    sample_store_t s;
+    sample_cursor_t c, stale;
+    uint32_t time_s;
+    int16_t values[SAMPLE_STORE_CHANNELS];
+
+    sample_store_init(&s, blocks, 4);
+    sample_store_begin(&s, &stale);
+    sample_store_append(&s, t->time[0], t->values[0]);
+    CHECK(sample_store_next(&s, &stale, &time_s, values));
+
+    for (int i = 1; i < 5000; i++) {
+        sample_store_append(&s, t->time[i], t->values[i]);
+    }
+    uint32_t kept = sample_store_count(&s);
+    CHECK(kept < 5000 && kept > 3 * 100);
+
+    // As guardadas são as últimas kept amostras do traço, em ordem
+    int i = 5000 - (int)kept, mismatches = 0;
+    sample_store_begin(&s, &c);
+    while (sample_store_next(&s, &c, &time_s, values)) {
+        mismatches += i >= 5000 || time_s != t->time[i] || memcmp(values, t->values[i], sizeof(values)) != 0;
+        i++;
+    }
+    CHECK_EQ(i, 5000);
+    CHECK_EQ(mismatches, 0);
+
+    CHECK(sample_store_next(&s, &stale, &time_s, values));
+    CHECK_EQ(time_s, t->time[5000 - kept]);
+}
+
+// Escapes: saltos de fundo de escala nos canais e tempo parado, para trás
+// ou com um buraco longo, misturados a trechos comuns
+static void test_escapes(void) {
+    sample_block_t blocks[64];
+    sample_store_t s;
+    sample_cursor_t c;
+    static const int16_t edges[] = { INT16_MIN, INT16_MAX, 0, -1, INT16_MAX, INT16_MIN };
+    static const int32_t gaps[] = { 1, 0, 1, -5, 1, 3600, 1, 1, 2, 1 };
+    uint32_t times[600], time_s = 5000;
+    int16_t values[600][SAMPLE_STORE_CHANNELS], out[SAMPLE_STORE_CHANNELS];
+    int mismatches = 0, n = 0;
+
+    sample_store_init(&s, blocks, 64);
+    for (int i = 0; i < 600; i++) {
+        times[i] = time_s;
+        for (int ch = 0; ch < SAMPLE_STORE_CHANNELS; ch++) {
+            values[i][ch] = i % 50 < 10 ? edges[(i + ch) % 6] : (int16_t)(1000 * ch + i % 7);
+        }
+        sample_store_append(&s, times[i], values[i]);
+        time_s += (uint32_t)gaps[i % 10];
+    }
+    CHECK_EQ(sample_store_count(&s), 600);
+
+    sample_store_begin(&s, &c);
+    while (n < 600 && sample_store_next(&s, &c, &time_s, out)) {
+        mismatches += time_s != times[n] || memcmp(out, values[n], sizeof(out)) != 0;
+        n++;
+    }
+    CHECK_EQ(n, 600);
+    CHECK_EQ(mismatches, 0);
+}
+
+int main(void) {
+    trace_t still, calm, rough;
+
+    make_trace(&still, DAY_S, 0, false);
+    make_trace(&calm, DAY_S, 2, false);
+    make_trace(&rough, DAY_S, 20, true);
+    test_wrap(&calm);
+    test_escapes();
+    run("sem ruído", &still, 0.50);
+    run("dia calmo", &calm, 1.25);
+    run("ruído e frentes", &rough, 2.55);
+    free_trace(&still);
+    free_trace(&calm);
+    free_trace(&rough);
+    return check_result("sample_store");
+}
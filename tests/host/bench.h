@@ -0,0 +1,18 @@
+// Cronômetro das medições no host. Os tempos servem para comparar
+// implementações entre si na mesma máquina, não preveem ciclos no RP2040.
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+#include <stdint.h>
+#include <time.h>
+
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Impede o compilador de descartar o resultado medido
+static volatile int64_t bench_sink;
+
+#endif
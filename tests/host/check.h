@@ -0,0 +1,35 @@
+// Verificação dos testes do host: registra a falha e segue, para que uma
+// execução mostre todos os casos quebrados. main retorna check_result().
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <stdio.h>
+
+static int check_failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+            check_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) do { \
+        long long check_a = (long long)(a), check_b = (long long)(b); \
+        if (check_a != check_b) { \
+            printf("%s:%d: falhou: %s == %s (%lld != %lld)\n", \
+                   __FILE__, __LINE__, #a, #b, check_a, check_b); \
+            check_failures++; \
+        } \
+    } while (0)
+
+static inline int check_result(const char *name) {
+    if (check_failures) {
+        printf("%s: %d falha(s)\n", name, check_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+#endif
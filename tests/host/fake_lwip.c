@@ -0,0 +1,240 @@
+#include <stdlib.h>
+#include <string.h>
+#include "lwip/tcp.h"
+
+static int pbufs_live;
+static struct tcp_pcb *listener;
+
+// ---------- pbuf ----------
+
+static struct pbuf *pbuf_copy_of(const char *data, u16_t len) {
+    struct pbuf *p = malloc(sizeof(*p) + len);
+    p->next = NULL;
+    p->payload = p + 1;
+    p->len = p->tot_len = len;
+    memcpy(p->payload, data, len);
+    pbufs_live++;
+    return p;
+}
+
+u8_t pbuf_free(struct pbuf *p) {
+    u8_t count = 0;
+    while (p) {
+        struct pbuf *next = p->next;
+        free(p);
+        pbufs_live--;
+        count++;
+        p = next;
+    }
+    return count;
+}
+
+void pbuf_cat(struct pbuf *head, struct pbuf *tail) {
+    struct pbuf *p = head;
+    for (; p->next; p = p->next) {
+        p->tot_len += tail->tot_len;
+    }
+    p->tot_len += tail->tot_len;
+    p->next = tail;
+}
+
+// Como no lwIP: libera os pbufs consumidos por inteiro e avança o payload
+// do primeiro que sobrou
+struct pbuf *pbuf_free_header(struct pbuf *q, u16_t size) {
+    while (q && size >= q->len) {
+        struct pbuf *next = q->next;
+        size -= q->len;
+        q->next = NULL;
+        pbuf_free(q);
+        q = next;
+    }
+    if (q && size) {
+        q->payload = (char *)q->payload + size;
+        q->len -= size;
+        q->tot_len -= size;
+    }
+    return q;
+}
+
+int fake_pbuf_live(void) {
+    return pbufs_live;
+}
+
+// ---------- TCP, lado do servidor ----------
+
+struct tcp_pcb *tcp_new(void) {
+    return calloc(1, sizeof(struct tcp_pcb));
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) {
+    (void)pcb, (void)ipaddr, (void)port;
+    return ERR_OK;
+}
+
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb) {
+    listener = pcb;
+    return pcb;
+}
+
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept) {
+    pcb->accept = accept;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg) {
+    pcb->arg = arg;
+}
+
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv) {
+    pcb->recv = recv;
+}
+
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent) {
+    pcb->sent = sent;
+}
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval) {
+    (void)interval;
+    pcb->poll = poll;
+}
+
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err) {
+    pcb->err = err;
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *data, u16_t len, u8_t apiflags) {
+    (void)apiflags;
+    if (pcb->closed || len > pcb->snd_buf) {
+        return ERR_MEM;
+    }
+    if (pcb->out_len + len > pcb->out_cap) {
+        pcb->out_cap = (pcb->out_len + len) * 2;
+        pcb->out = realloc(pcb->out, pcb->out_cap + 1);
+    }
+    memcpy(pcb->out + pcb->out_len, data, len);
+    pcb->out_len += len;
+    pcb->out[pcb->out_len] = '\0';
+    pcb->unacked += len;
+    pcb->snd_buf -= len;
+    return ERR_OK;
+}
+
+err_t tcp_output(struct tcp_pcb *pcb) {
+    (void)pcb;
+    return ERR_OK;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len) {
+    pcb->recved += len;
+}
+
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb) {
+    return pcb->snd_buf;
+}
+
+// O PCB continua com o teste para inspeção; ele libera com fake_tcp_free
+err_t tcp_close(struct tcp_pcb *pcb) {
+    pcb->closed = true;
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb) {
+    pcb->closed = true;
+    pcb->aborted = true;
+}
+
+// ---------- TCP, lado do cliente ----------
+
+struct tcp_pcb *fake_tcp_connect(u16_t snd_buf) {
+    struct tcp_pcb *pcb = tcp_new();
+    pcb->snd_buf = snd_buf;
+    if (!listener || !listener->accept || listener->accept(listener->arg, pcb, ERR_OK) != ERR_OK) {
+        pcb->closed = true;
+    }
+    return pcb;
+}
+
+static err_t deliver(struct tcp_pcb *pcb, struct pbuf *p) {
+    if (pcb->closed || !pcb->recv) {
+        pbuf_free(p);
+        return ERR_VAL;
+    }
+    return pcb->recv(pcb->arg, pcb, p, ERR_OK);
+}
+
+err_t fake_tcp_send(struct tcp_pcb *pcb, const char *data, size_t len) {
+    return deliver(pcb, pbuf_copy_of(data, (u16_t)len));
+}
+
+// Um recv por segmento de até seg bytes
+err_t fake_tcp_send_segments(struct tcp_pcb *pcb, const char *data, size_t len, size_t seg) {
+    err_t err = ERR_OK;
+    for (size_t off = 0; off < len && err == ERR_OK; off += seg) {
+        size_t n = len - off < seg ? len - off : seg;
+        err = deliver(pcb, pbuf_copy_of(data + off, (u16_t)n));
+    }
+    return err;
+}
+
+// Um só recv com uma cadeia de pbufs de até seg bytes cada
+err_t fake_tcp_send_chain(struct tcp_pcb *pcb, const char *data, size_t len, size_t seg) {
+    struct pbuf *head = NULL;
+    for (size_t off = 0; off < len; off += seg) {
+        size_t n = len - off < seg ? len - off : seg;
+        struct pbuf *p = pbuf_copy_of(data + off, (u16_t)n);
+        if (head) {
+            pbuf_cat(head, p);
+        } else {
+            head = p;
+        }
+    }
+    return head ? deliver(pcb, head) : ERR_OK;
+}
+
+err_t fake_tcp_fin(struct tcp_pcb *pcb) {
+    if (pcb->closed || !pcb->recv) {
+        return ERR_VAL;
+    }
+    return pcb->recv(pcb->arg, pcb, NULL, ERR_OK);
+}
+
+err_t fake_tcp_ack(struct tcp_pcb *pcb, size_t len) {
+    if (len > pcb->unacked) {
+        len = pcb->unacked;
+    }
+    pcb->unacked -= len;
+    pcb->snd_buf += (u16_t)len;
+    if (len == 0 || pcb->closed || !pcb->sent) {
+        return ERR_OK;
+    }
+    return pcb->sent(pcb->arg, pcb, (u16_t)len);
+}
+
+// Confirma tudo, inclusive o que o servidor escrever em resposta aos ACKs
+err_t fake_tcp_ack_all(struct tcp_pcb *pcb) {
+    err_t err = ERR_OK;
+    while (pcb->unacked && !pcb->closed && err == ERR_OK) {
+        err = fake_tcp_ack(pcb, pcb->unacked);
+    }
+    return err;
+}
+
+err_t fake_tcp_tick(struct tcp_pcb *pcb) {
+    if (pcb->closed || !pcb->poll) {
+        return ERR_VAL;
+    }
+    return pcb->poll(pcb->arg, pcb);
+}
+
+// Ocorrências de text em tudo que o servidor escreveu no PCB
+size_t fake_tcp_count(const struct tcp_pcb *pcb, const char *text) {
+    size_t count = 0;
+    for (const char *p = pcb->out; p && (p = strstr(p, text)); p += strlen(text)) {
+        count++;
+    }
+    return count;
+}
+
+void fake_tcp_free(struct tcp_pcb *pcb) {
+    free(pcb->out);
+    free(pcb);
+}
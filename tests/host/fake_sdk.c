@@ -0,0 +1,294 @@
+// Periféricos do firmware no host: tudo aceita a configuração e não faz
+// nada, exceto a flash (uma matriz em RAM) e os sensores, que não
+// respondem no barramento. Basta para ligar Trabalho_SE_11.c aos testes.
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "pico/bootrom.h"
+#include "pico/flash.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/systick.h"
+#include "ws2818b.pio.h"
+
+bool stdio_init_all(void) {
+    return true;
+}
+
+// ---------- Alarmes: registrados, nunca disparados ----------
+
+static alarm_id_t next_alarm_id = 1;
+
+alarm_pool_t *alarm_pool_get_default(void) {
+    return NULL;
+}
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers) {
+    (void)max_timers;
+    return NULL;
+}
+
+alarm_id_t alarm_pool_add_alarm_at(alarm_pool_t *pool, absolute_time_t time, alarm_callback_t callback,
+                                   void *user_data, bool fire_if_past) {
+    (void)pool, (void)time, (void)callback, (void)user_data, (void)fire_if_past;
+    return next_alarm_id++;
+}
+
+alarm_id_t alarm_pool_add_alarm_in_ms(alarm_pool_t *pool, uint32_t ms, alarm_callback_t callback,
+                                      void *user_data, bool fire_if_past) {
+    (void)pool, (void)ms, (void)callback, (void)user_data, (void)fire_if_past;
+    return next_alarm_id++;
+}
+
+bool alarm_pool_cancel_alarm(alarm_pool_t *pool, alarm_id_t alarm_id) {
+    (void)pool, (void)alarm_id;
+    return true;
+}
+
+// ---------- Núcleos e interrupções ----------
+
+armv6m_scb_hw_t host_scb;
+systick_hw_t host_systick;
+
+uint32_t save_and_disable_interrupts(void) {
+    return 0;
+}
+
+void restore_interrupts(uint32_t status) {
+    (void)status;
+}
+
+uint get_core_num(void) {
+    return 0;
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    (void)entry;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    (void)num, (void)enabled;
+}
+
+void reset_usb_boot(uint32_t usb_activity_gpio_pin_mask, uint32_t disable_interface_mask) {
+    (void)usb_activity_gpio_pin_mask, (void)disable_interface_mask;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    (void)clk_index;
+    return 125000000;
+}
+
+// ---------- GPIO, PWM, PIO e DMA ----------
+
+void gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    (void)gpio, (void)out;
+}
+
+void gpio_put(uint gpio, bool value) {
+    (void)gpio, (void)value;
+}
+
+bool gpio_get(uint gpio) {
+    (void)gpio;
+    return true;                         // Botões com pull-up, soltos
+}
+
+void gpio_pull_up(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_function(uint gpio, uint fn) {
+    (void)gpio, (void)fn;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    (void)gpio, (void)event_mask, (void)enabled;
+}
+
+void gpio_set_irq_callback(gpio_irq_callback_t callback) {
+    (void)callback;
+}
+
+uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1) & 7;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+    (void)slice_num, (void)wrap;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider) {
+    (void)slice_num, (void)divider;
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level) {
+    (void)gpio, (void)level;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+    (void)slice_num, (void)enabled;
+}
+
+pio_hw_t pio0_hw;
+const pio_program_t ws2818b_program;
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    (void)pio, (void)program;
+    return 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    (void)pio, (void)required;
+    return 0;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    (void)pio, (void)sm, (void)is_tx;
+    return 0;
+}
+
+void ws2818b_program_init(PIO pio, uint sm, uint offset, uint pin, float freq) {
+    (void)pio, (void)sm, (void)offset, (void)pin, (void)freq;
+}
+
+int dma_claim_unused_channel(bool required) {
+    (void)required;
+    return 0;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    (void)channel;
+    return (dma_channel_config){ 0 };
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    (void)c, (void)size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    (void)c, (void)incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    (void)c, (void)incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    (void)c, (void)dreq;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    (void)channel, (void)config, (void)write_addr, (void)read_addr, (void)transfer_count, (void)trigger;
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    (void)channel, (void)read_addr, (void)transfer_count;
+}
+
+bool dma_channel_is_busy(uint channel) {
+    (void)channel;
+    return false;
+}
+
+void dma_channel_abort(uint channel) {
+    (void)channel;
+}
+
+// ---------- I2C: nenhum dispositivo responde ----------
+
+static i2c_hw_t i2c_regs[2];
+i2c_inst_t *const host_i2c0 = (i2c_inst_t *)&i2c_regs[0];
+i2c_inst_t *const host_i2c1 = (i2c_inst_t *)&i2c_regs[1];
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    (void)i2c;
+    return baudrate;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return (i2c_hw_t *)i2c;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    (void)i2c, (void)is_tx;
+    return 0;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c, (void)addr, (void)src, (void)len, (void)nostop;
+    return PICO_ERROR_GENERIC;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)i2c, (void)addr, (void)dst, (void)len, (void)nostop;
+    return PICO_ERROR_GENERIC;
+}
+
+// ---------- Flash ----------
+
+uint8_t host_flash[PICO_FLASH_SIZE_BYTES];
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    memset(host_flash + flash_offs, 0xFF, count);
+}
+
+// Como na flash real, programar só derruba bits
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        host_flash[flash_offs + i] &= data[i];
+    }
+}
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+bool flash_safe_execute_core_init(void) {
+    return true;
+}
+
+// ---------- WiFi ----------
+
+cyw43_t cyw43_state;
+
+int cyw43_arch_init(void) {
+    return 0;
+}
+
+void cyw43_arch_enable_sta_mode(void) {
+}
+
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout) {
+    (void)ssid, (void)pw, (void)auth, (void)timeout;
+    return 0;
+}
+
+int cyw43_tcpip_link_status(cyw43_t *self, int itf) {
+    (void)self, (void)itf;
+    return CYW43_LINK_UP;
+}
+
+void cyw43_arch_poll(void) {
+}
+
+void cyw43_arch_lwip_begin(void) {
+}
+
+void cyw43_arch_lwip_end(void) {
+}
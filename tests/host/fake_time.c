@@ -0,0 +1,51 @@
+#include "pico/stdlib.h"
+
+static uint64_t now_us;
+
+uint64_t time_us_64(void) {
+    return now_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)now_us;
+}
+
+absolute_time_t get_absolute_time(void) {
+    return now_us;
+}
+
+absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return now_us + (uint64_t)ms * 1000;
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us) {
+    return now_us + us;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+bool time_reached(absolute_time_t t) {
+    return now_us >= t;
+}
+
+void sleep_ms(uint32_t ms) {
+    now_us += (uint64_t)ms * 1000;
+}
+
+void sleep_us(uint64_t us) {
+    now_us += us;
+}
+
+void fake_time_advance_us(uint64_t us) {
+    now_us += us;
+}
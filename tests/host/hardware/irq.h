@@ -0,0 +1,11 @@
+#ifndef HOST_HARDWARE_IRQ_H
+#define HOST_HARDWARE_IRQ_H
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#define IO_IRQ_BANK0 13
+
+void irq_set_enabled(uint num, bool enabled);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef HOST_HARDWARE_STRUCTS_SYSTICK_H
+#define HOST_HARDWARE_STRUCTS_SYSTICK_H
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    volatile uint32_t csr;
+    volatile uint32_t rvr;
+    volatile uint32_t cvr;
+    const volatile uint32_t calib;
+} systick_hw_t;
+
+extern systick_hw_t host_systick;
+#define systick_hw (&host_systick)
+
+#endif
@@ -0,0 +1,20 @@
+// Um só núcleo e sem interrupções no host: barreiras e eventos são vazios
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+static inline void __wfe(void) {}
+static inline void __sev(void) {}
+static inline void __dmb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+static inline void __compiler_memory_barrier(void) {
+    __asm__ volatile ("" ::: "memory");
+}
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+uint get_core_num(void);
+
+#endif
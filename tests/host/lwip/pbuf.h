@@ -0,0 +1,27 @@
+// pbufs do lwIP falso (host/fake_lwip.c): cadeias alocadas com malloc, com
+// as mesmas regras de len/tot_len da pilha real
+#ifndef HOST_LWIP_PBUF_H
+#define HOST_LWIP_PBUF_H
+
+#include <stdint.h>
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int8_t err_t;
+
+struct pbuf {
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;
+    u16_t len;
+};
+
+u8_t pbuf_free(struct pbuf *p);
+void pbuf_cat(struct pbuf *head, struct pbuf *tail);
+struct pbuf *pbuf_free_header(struct pbuf *q, u16_t size);
+
+// Só no host: pbufs ainda não liberados, para achar vazamentos
+int fake_pbuf_live(void);
+
+#endif
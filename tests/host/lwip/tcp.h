@@ -0,0 +1,74 @@
+// API raw TCP do lwIP falso. Cada PCB guarda os callbacks registrados pelo
+// servidor e tudo que ele escreveu; o teste faz o papel da rede com as
+// funções fake_tcp_* (recebe, confirma, dispara o poll).
+#ifndef HOST_LWIP_TCP_H
+#define HOST_LWIP_TCP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwip/pbuf.h"
+#include "pico/cyw43_arch.h"
+
+#define ERR_OK 0
+#define ERR_MEM -1
+#define ERR_ABRT -13
+#define ERR_VAL -6
+
+#define IP_ADDR_ANY ((const ip_addr_t *)0)
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+struct tcp_pcb;
+typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *newpcb, err_t err);
+typedef err_t (*tcp_recv_fn)(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+typedef err_t (*tcp_sent_fn)(void *arg, struct tcp_pcb *tpcb, u16_t len);
+typedef err_t (*tcp_poll_fn)(void *arg, struct tcp_pcb *tpcb);
+typedef void (*tcp_err_fn)(void *arg, err_t err);
+
+struct tcp_pcb {
+    void *arg;
+    tcp_accept_fn accept;
+    tcp_recv_fn recv;
+    tcp_sent_fn sent;
+    tcp_poll_fn poll;
+    tcp_err_fn err;
+
+    char *out;                           // Tudo que o servidor escreveu
+    size_t out_len;
+    size_t out_cap;
+    size_t unacked;                      // Escrito e ainda não confirmado
+    u16_t snd_buf;                       // Espaço de envio livre
+    size_t recved;                       // Soma de tcp_recved
+    bool closed;
+    bool aborted;
+};
+
+struct tcp_pcb *tcp_new(void);
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port);
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb);
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept);
+void tcp_arg(struct tcp_pcb *pcb, void *arg);
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv);
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent);
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval);
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err);
+err_t tcp_write(struct tcp_pcb *pcb, const void *data, u16_t len, u8_t apiflags);
+err_t tcp_output(struct tcp_pcb *pcb);
+void tcp_recved(struct tcp_pcb *pcb, u16_t len);
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb);
+err_t tcp_close(struct tcp_pcb *pcb);
+void tcp_abort(struct tcp_pcb *pcb);
+
+// Só no host: o lado do cliente
+struct tcp_pcb *fake_tcp_connect(u16_t snd_buf);
+err_t fake_tcp_send(struct tcp_pcb *pcb, const char *data, size_t len);
+err_t fake_tcp_send_segments(struct tcp_pcb *pcb, const char *data, size_t len, size_t seg);
+err_t fake_tcp_send_chain(struct tcp_pcb *pcb, const char *data, size_t len, size_t seg);
+err_t fake_tcp_fin(struct tcp_pcb *pcb);
+err_t fake_tcp_ack(struct tcp_pcb *pcb, size_t len);
+err_t fake_tcp_ack_all(struct tcp_pcb *pcb);
+err_t fake_tcp_tick(struct tcp_pcb *pcb);
+size_t fake_tcp_count(const struct tcp_pcb *pcb, const char *text);
+void fake_tcp_free(struct tcp_pcb *pcb);
+
+#endif
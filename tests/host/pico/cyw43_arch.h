@@ -0,0 +1,32 @@
+#ifndef HOST_PICO_CYW43_ARCH_H
+#define HOST_PICO_CYW43_ARCH_H
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    uint32_t addr;
+} ip_addr_t;
+
+struct netif {
+    ip_addr_t ip_addr;
+};
+
+typedef struct {
+    struct netif netif[2];
+} cyw43_t;
+
+extern cyw43_t cyw43_state;
+
+#define CYW43_ITF_STA 0
+#define CYW43_LINK_UP 3
+#define CYW43_AUTH_WPA2_MIXED_PSK 0x00400006
+
+int cyw43_arch_init(void);
+void cyw43_arch_enable_sta_mode(void);
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout);
+int cyw43_tcpip_link_status(cyw43_t *self, int itf);
+void cyw43_arch_poll(void);
+void cyw43_arch_lwip_begin(void);
+void cyw43_arch_lwip_end(void);
+
+#endif
@@ -0,0 +1,12 @@
+// No lugar do cabeçalho gerado por pico_generate_pio_header a partir de
+// ws2818b.pio; o programa não roda no host
+#ifndef HOST_WS2818B_PIO_H
+#define HOST_WS2818B_PIO_H
+
+#include "hardware/pio.h"
+
+extern const pio_program_t ws2818b_program;
+
+void ws2818b_program_init(PIO pio, uint sm, uint offset, uint pin, float freq);
+
+#endif
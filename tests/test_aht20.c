@@ -0,0 +1,215 @@
+// Dublê do AHT20 no barramento I2C falso: a conversão disparada por 0xAC
+// leva conversion_us no relógio falso e o status fica ocupado até lá.
+// Confere a máquina de estados trigger/poll_ready/collect e o CRC.
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "aht20.h"
+#include "check.h"
+
+static struct {
+    uint64_t conversion_us;              // Duração da conversão simulada
+    uint64_t ready_at;                   // Fim da conversão em andamento
+    bool converting;
+    bool nack;                           // Próxima transferência falha
+    bool corrupt_crc;
+    uint32_t raw_humidity;               // 20 bits
+    uint32_t raw_temp;                   // 20 bits
+    int reads;
+    int writes;
+} dev;
+
+// CRC-8 escrito à parte do driver: polinômio 0x31, valor inicial 0xFF
+static uint8_t ref_crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        for (int b = 7; b >= 0; b--) {
+            bool top = ((crc >> 7) ^ (data[i] >> b)) & 1;
+            crc = (uint8_t)(crc << 1);
+            if (top) {
+                crc ^= 0x31;
+            }
+        }
+    }
+    return crc;
+}
+
+static bool busy(void) {
+    return dev.converting && time_us_64() < dev.ready_at;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c;
+    (void)nostop;
+    dev.writes++;
+    if (addr != AHT20_I2C_ADDR || dev.nack) {
+        return PICO_ERROR_GENERIC;
+    }
+    if (len == 3 && src[0] == AHT20_CMD_TRIGGER && src[1] == 0x33 && src[2] == 0x00) {
+        dev.converting = true;
+        dev.ready_at = time_us_64() + dev.conversion_us;
+    }
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)i2c;
+    (void)nostop;
+    dev.reads++;
+    if (addr != AHT20_I2C_ADDR || dev.nack) {
+        return PICO_ERROR_GENERIC;
+    }
+
+    uint8_t frame[7];
+    frame[0] = (busy() ? 0x80 : 0x00) | 0x08;
+    frame[1] = (uint8_t)(dev.raw_humidity >> 12);
+    frame[2] = (uint8_t)(dev.raw_humidity >> 4);
+    frame[3] = (uint8_t)((dev.raw_humidity << 4) | (dev.raw_temp >> 16));
+    frame[4] = (uint8_t)(dev.raw_temp >> 8);
+    frame[5] = (uint8_t)dev.raw_temp;
+    frame[6] = ref_crc8(frame, 6) ^ (dev.corrupt_crc ? 0x01 : 0x00);
+    memcpy(dst, frame, len < sizeof(frame) ? len : sizeof(frame));
+    return (int)len;
+}
+
+static void dev_reset(void) {
+    memset(&dev, 0, sizeof(dev));
+    dev.conversion_us = AHT20_MEASURE_TIME_MS * 1000;
+    dev.raw_humidity = 1u << 19;         // 50,00 %UR
+    dev.raw_temp = 393216;               // 0,375 * 2^20 -> 25,00 °C
+}
+
+static void test_crc_reference(void) {
+    // Valor de verificação do CRC-8 (0x31, init 0xFF) para "123456789"
+    CHECK_EQ(ref_crc8((const uint8_t *)"123456789", 9), 0xF7);
+}
+
+static void test_split_phase(void) {
+    AHT20_Data data = { .temperature = -1, .humidity = -1 };
+
+    dev_reset();
+    CHECK(!aht20_poll_ready(NULL));      // Nada disparado
+    CHECK(aht20_trigger(NULL));
+
+    // Antes do tempo nominal o driver nem toca no barramento
+    int reads = dev.reads;
+    fake_time_advance_us(AHT20_MEASURE_TIME_MS * 1000 - 1);
+    CHECK(!aht20_poll_ready(NULL));
+    CHECK_EQ(dev.reads, reads);
+
+    fake_time_advance_us(1);
+    CHECK(aht20_poll_ready(NULL));
+    CHECK(aht20_collect(NULL, &data));
+    CHECK_EQ(data.temperature, 2500);
+    CHECK_EQ(data.humidity, 5000);
+
+    // Coletado: só um novo disparo volta a produzir amostra
+    CHECK(!aht20_poll_ready(NULL));
+}
+
+static void test_slow_sensor(void) {
+    AHT20_Data data;
+
+    // Sensor que demora mais que o nominal: o status decide, não o relógio
+    dev_reset();
+    dev.conversion_us = 95000;
+    CHECK(aht20_trigger(NULL));
+    fake_time_advance_us(AHT20_MEASURE_TIME_MS * 1000);
+    CHECK(!aht20_poll_ready(NULL));
+    fake_time_advance_us(10000);
+    CHECK(!aht20_poll_ready(NULL));
+    fake_time_advance_us(5000);
+    CHECK(aht20_poll_ready(NULL));
+    CHECK(aht20_collect(NULL, &data));
+}
+
+static void test_collect_rejects(void) {
+    AHT20_Data data = { .temperature = 1234, .humidity = 5678 };
+
+    // CRC errado: falha e não altera a amostra anterior
+    dev_reset();
+    dev.corrupt_crc = true;
+    CHECK(aht20_trigger(NULL));
+    fake_time_advance_us(AHT20_MEASURE_TIME_MS * 1000);
+    CHECK(aht20_poll_ready(NULL));
+    CHECK(!aht20_collect(NULL, &data));
+    CHECK_EQ(data.temperature, 1234);
+    CHECK_EQ(data.humidity, 5678);
+
+    // Coleta antecipada com o sensor ainda ocupado
+    dev_reset();
+    CHECK(aht20_trigger(NULL));
+    fake_time_advance_us(1000);
+    CHECK(!aht20_collect(NULL, &data));
+    CHECK_EQ(data.temperature, 1234);
+
+    // Disparo sem ACK não deixa conversão pendente
+    dev_reset();
+    dev.nack = true;
+    CHECK(!aht20_trigger(NULL));
+    dev.nack = false;
+    fake_time_advance_us(AHT20_MEASURE_TIME_MS * 1000);
+    CHECK(!aht20_poll_ready(NULL));
+}
+
+static void test_back_to_back(void) {
+    AHT20_Data data;
+
+    // Como no laço principal: dispara a próxima logo após coletar
+    dev_reset();
+    CHECK(aht20_trigger(NULL));
+    for (int i = 0; i < 5; i++) {
+        dev.raw_temp = 393216 + (uint32_t)i * 5243;   // ~+1 °C por amostra
+        fake_time_advance_us(AHT20_MEASURE_TIME_MS * 1000);
+        CHECK(aht20_poll_ready(NULL));
+        CHECK(aht20_collect(NULL, &data));
+        CHECK(data.temperature >= 2500 + i * 100 - 1 && data.temperature <= 2500 + i * 100 + 1);
+        CHECK(aht20_trigger(NULL));
+        CHECK(!aht20_poll_ready(NULL));
+    }
+}
+
+static void test_blocking_read(void) {
+    AHT20_Data data;
+
+    // aht20_read continua funcionando sobre as três fases
+    dev_reset();
+    uint64_t start = time_us_64();
+    CHECK(aht20_read(NULL, &data));
+    CHECK(time_us_64() - start >= AHT20_MEASURE_TIME_MS * 1000);
+    CHECK_EQ(data.temperature, 2500);
+
+    dev_reset();
+    dev.conversion_us = 1000000;         // Nunca fica pronto a tempo
+    CHECK(!aht20_read(NULL, &data));
+    CHECK(!aht20_poll_ready(NULL));
+}
+
+static void test_conversion_range(void) {
+    AHT20_Data data;
+
+    // Extremos da escala: 0x00000 e 0xFFFFF
+    dev_reset();
+    dev.raw_humidity = 0;
+    dev.raw_temp = 0;
+    CHECK(aht20_read(NULL, &data));
+    CHECK_EQ(data.temperature, -5000);
+    CHECK_EQ(data.humidity, 0);
+
+    dev.raw_humidity = 0xFFFFF;
+    dev.raw_temp = 0xFFFFF;
+    CHECK(aht20_read(NULL, &data));
+    CHECK_EQ(data.temperature, 15000);
+    CHECK_EQ(data.humidity, 10000);
+}
+
+int main(void) {
+    test_crc_reference();
+    test_split_phase();
+    test_slow_sensor();
+    test_collect_rejects();
+    test_back_to_back();
+    test_blocking_read();
+    test_conversion_range();
+    return check_result("aht20");
+}
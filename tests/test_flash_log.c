@@ -0,0 +1,319 @@
+// Log circular da flash contra um emulador em RAM com a semântica da NOR:
+// apagar deixa 0xFF, programar só derruba bits, e uma gravação pode ser
+// cortada no meio (queda de energia). Cobre acréscimo em lote, rotação e
+// desgaste dos setores, recuperação ao reabrir, página rasgada, registro
+// corrompido e o iterador durante a reciclagem de setores.
+#include <stdio.h>
+#include <string.h>
+#include "flash_log.h"
+#include "check.h"
+
+#define SECTORS 4
+#define PAGES_PER_SECTOR (FLASH_LOG_SECTOR_SIZE / FLASH_LOG_PAGE_SIZE)
+#define RECORDS_PER_PAGE (FLASH_LOG_PAGE_SIZE / sizeof(flash_log_record_t))
+#define RECORDS_PER_SECTOR ((PAGES_PER_SECTOR - 1) * RECORDS_PER_PAGE)
+
+typedef struct {
+    uint8_t mem[SECTORS * FLASH_LOG_SECTOR_SIZE];
+    uint32_t erases[SECTORS];
+    uint32_t programs;
+    uint32_t busy_erases;                // Apagamentos fora de um momento ocioso
+    bool idle;                           // O teste está dentro de flash_log_service(log, true)
+    int tear_after;                      // >= 0: a próxima gravação para nesse byte e falha
+    bool misaligned;
+} flash_emu_t;
+
+static bool emu_erase(void *ctx, uint32_t offset) {
+    flash_emu_t *emu = ctx;
+    if (offset % FLASH_LOG_SECTOR_SIZE || offset >= sizeof(emu->mem)) {
+        emu->misaligned = true;
+        return false;
+    }
+    memset(emu->mem + offset, 0xFF, FLASH_LOG_SECTOR_SIZE);
+    emu->erases[offset / FLASH_LOG_SECTOR_SIZE]++;
+    emu->busy_erases += !emu->idle;
+    return true;
+}
+
+static bool emu_program(void *ctx, uint32_t offset, const uint8_t *page) {
+    flash_emu_t *emu = ctx;
+    int n = FLASH_LOG_PAGE_SIZE;
+    if (offset % FLASH_LOG_PAGE_SIZE || offset >= sizeof(emu->mem)) {
+        emu->misaligned = true;
+        return false;
+    }
+    if (emu->tear_after >= 0) {
+        n = emu->tear_after;
+    }
+    for (int i = 0; i < n; i++) {
+        emu->mem[offset + i] &= page[i];
+    }
+    emu->programs++;
+    if (emu->tear_after >= 0) {
+        emu->tear_after = -1;
+        return false;
+    }
+    return true;
+}
+
+static flash_emu_t emu;
+static const flash_log_backend_t backend = {
+    .base = emu.mem,
+    .sector_count = SECTORS,
+    .erase = emu_erase,
+    .program = emu_program,
+    .ctx = &emu,
+};
+
+static void emu_reset(uint8_t fill) {
+    memset(&emu, 0, sizeof(emu));
+    memset(emu.mem, fill, sizeof(emu.mem));
+    emu.tear_after = -1;
+}
+
+// Payload derivado da seq, para conferir o conteúdo na leitura
+static void make_payload(uint32_t seq, uint8_t *payload) {
+    for (int i = 0; i < FLASH_LOG_PAYLOAD; i++) {
+        payload[i] = (uint8_t)(seq * 31 + i);
+    }
+}
+
+// Acrescenta com o laço principal ocioso a cada registro, como o flash_task
+static void append_n(flash_log_t *log, uint32_t n) {
+    uint8_t payload[FLASH_LOG_PAYLOAD];
+    for (uint32_t i = 0; i < n; i++) {
+        make_payload(log->next_seq, payload);
+        CHECK(flash_log_append(log, payload));
+        emu.idle = true;
+        flash_log_service(log, true);
+        emu.idle = false;
+    }
+}
+
+// Lê a partir de from; retorna quantos vieram, em ordem e sem repetir, e
+// confere o conteúdo. first/last: primeira e última seq lidas.
+static uint32_t read_all(const flash_log_t *log, uint32_t from, uint32_t *first, uint32_t *last) {
+    flash_log_iter_t it;
+    uint8_t payload[FLASH_LOG_PAYLOAD], expected[FLASH_LOG_PAYLOAD];
+    uint32_t seq, prev = 0, count = 0;
+
+    *first = *last = 0;
+    flash_log_seek(log, &it, from);
+    while (flash_log_next(log, &it, &seq, payload)) {
+        make_payload(seq, expected);
+        CHECK(seq > prev && seq >= from);
+        CHECK(memcmp(payload, expected, sizeof(payload)) == 0);
+        if (!count) {
+            *first = seq;
+        }
+        prev = *last = seq;
+        count++;
+    }
+    return count;
+}
+
+static void test_fresh(void) {
+    flash_log_t log;
+    uint32_t first, last;
+
+    // Região apagada e região com lixo começam do zero
+    emu_reset(0xFF);
+    CHECK(flash_log_open(&log, &backend));
+    CHECK_EQ(log.next_seq, 1);
+    CHECK_EQ(flash_log_oldest(&log), 1);
+    CHECK_EQ(read_all(&log, 0, &first, &last), 0);
+
+    emu_reset(0x5A);
+    CHECK(flash_log_open(&log, &backend));
+    CHECK_EQ(log.next_seq, 1);
+    CHECK_EQ(read_all(&log, 0, &first, &last), 0);
+    CHECK(!emu.misaligned);
+}
+
+static void test_append_batched(void) {
+    flash_log_t log;
+    uint32_t first, last;
+
+    emu_reset(0xFF);
+    flash_log_open(&log, &backend);
+    uint32_t programs = emu.programs;
+
+    // Registros ainda em RAM já aparecem para o iterador
+    append_n(&log, 3);
+    CHECK_EQ(emu.programs, programs);
+    CHECK_EQ(read_all(&log, 0, &first, &last), 3);
+    CHECK_EQ(last, 3);
+
+    // Uma gravação por página cheia, não por registro
+    append_n(&log, 5 * RECORDS_PER_PAGE - 3);
+    CHECK_EQ(emu.programs - programs, 5);
+    CHECK_EQ(read_all(&log, 0, &first, &last), 5 * RECORDS_PER_PAGE);
+
+    // Seek no meio entrega a partir da seq pedida
+    CHECK_EQ(read_all(&log, 20, &first, &last), 5 * RECORDS_PER_PAGE - 19);
+    CHECK_EQ(first, 20);
+    CHECK(!emu.misaligned);
+}
+
+static void test_rotation(void) {
+    flash_log_t log;
+    uint32_t first, last;
+    uint32_t total = SECTORS * RECORDS_PER_SECTOR * 6 + 17;
+
+    emu_reset(0xFF);
+    flash_log_open(&log, &backend);
+    emu.busy_erases = 0;                 // O setor 0 é apagado na abertura, no boot
+    append_n(&log, total);
+
+    // Apagamentos só nos momentos ociosos, e distribuídos por igual
+    CHECK_EQ(emu.busy_erases, 0);
+    uint32_t min = emu.erases[0], max = emu.erases[0];
+    for (int s = 1; s < SECTORS; s++) {
+        min = emu.erases[s] < min ? emu.erases[s] : min;
+        max = emu.erases[s] > max ? emu.erases[s] : max;
+    }
+    CHECK(max - min <= 1);
+
+    // Ficam os mais novos, contíguos até o último
+    uint32_t count = read_all(&log, 0, &first, &last);
+    CHECK_EQ(last, total);
+    CHECK_EQ(first, flash_log_oldest(&log));
+    CHECK_EQ(count, last - first + 1);
+    CHECK(count >= (SECTORS - 2) * RECORDS_PER_SECTOR);
+
+    // Sem o laço ocioso o append ainda funciona: grava e apaga na hora
+    uint8_t payload[FLASH_LOG_PAYLOAD];
+    for (uint32_t i = 0; i < 2 * RECORDS_PER_SECTOR; i++) {
+        make_payload(log.next_seq, payload);
+        CHECK(flash_log_append(&log, payload));
+    }
+    CHECK(emu.busy_erases > 0);
+    CHECK_EQ(read_all(&log, 0, &first, &last), last - first + 1);
+    CHECK_EQ(last, total + 2 * RECORDS_PER_SECTOR);
+}
+
+static void test_reopen(void) {
+    flash_log_t log, again;
+    uint32_t first, last, count;
+
+    emu_reset(0xFF);
+    flash_log_open(&log, &backend);
+    append_n(&log, SECTORS * RECORDS_PER_SECTOR + 50);
+    CHECK(flash_log_flush(&log));
+    count = read_all(&log, 0, &first, &last);
+
+    // Depois do flush, reabrir recupera tudo e continua a numeração
+    uint32_t programs = emu.programs;
+    CHECK(flash_log_open(&again, &backend));
+    CHECK_EQ(emu.programs, programs);    // Abrir não grava nada
+    CHECK_EQ(again.next_seq, log.next_seq);
+    CHECK_EQ(flash_log_oldest(&again), flash_log_oldest(&log));
+    CHECK_EQ(read_all(&again, 0, &first, &last), count);
+
+    append_n(&again, 10);
+    CHECK_EQ(read_all(&again, 0, &first, &last), count + 10);
+    CHECK_EQ(last, log.next_seq + 9);
+
+    // Reset sem flush: só se perde o que estava em RAM
+    uint32_t programmed = again.next_seq - 1 - again.slot;
+    CHECK(again.slot > 0);
+    CHECK(flash_log_open(&log, &backend));
+    CHECK_EQ(log.next_seq, programmed + 1);
+    read_all(&log, 0, &first, &last);
+    CHECK_EQ(last, programmed);
+}
+
+static void test_torn_page(void) {
+    flash_log_t log;
+    uint8_t payload[FLASH_LOG_PAYLOAD];
+    uint32_t first, last;
+
+    emu_reset(0xFF);
+    flash_log_open(&log, &backend);
+    append_n(&log, 3 * RECORDS_PER_PAGE);
+
+    // Queda de energia no meio da gravação da página seguinte: os registros
+    // inteiros dela valem, o cortado tem CRC errado e é pulado
+    for (uint32_t i = 0; i < RECORDS_PER_PAGE; i++) {
+        make_payload(log.next_seq, payload);
+        flash_log_append(&log, payload);
+    }
+    emu.tear_after = 3 * sizeof(flash_log_record_t) + 10;
+    CHECK(!flash_log_flush(&log));
+
+    CHECK(flash_log_open(&log, &backend));
+    CHECK_EQ(read_all(&log, 0, &first, &last), 3 * RECORDS_PER_PAGE + 3);
+    CHECK_EQ(last, 3 * RECORDS_PER_PAGE + 3);
+
+    // Os novos vão para a página seguinte, com seq que não repete
+    append_n(&log, 2 * RECORDS_PER_PAGE);
+    CHECK(flash_log_flush(&log));
+    CHECK(flash_log_open(&log, &backend));
+    uint32_t count = read_all(&log, 0, &first, &last);
+    uint32_t before = last;
+    CHECK_EQ(count, 5 * RECORDS_PER_PAGE + 3);
+    CHECK_EQ(last, log.next_seq - 1);
+
+    // Um bit trocado na flash derruba só aquele registro
+    emu.mem[FLASH_LOG_PAGE_SIZE + 5 * sizeof(flash_log_record_t) + 7] ^= 0x10;
+    CHECK_EQ(read_all(&log, 0, &first, &last), count - 1);
+
+    // Cabeçalho de setor corrompido: o setor some na abertura, o resto fica
+    append_n(&log, RECORDS_PER_SECTOR);
+    CHECK(flash_log_flush(&log));
+    emu.mem[4] ^= 0x01;                  // first_seq do setor 0
+    CHECK(flash_log_open(&log, &backend));
+    count = read_all(&log, 0, &first, &last);
+    CHECK(first > before);
+    CHECK_EQ(count, last - first + 1);
+}
+
+// Leitor lento (exportação HTTP) enquanto o log dá a volta na região
+static void test_iterator_recycle(void) {
+    flash_log_t log;
+    flash_log_iter_t it;
+    uint8_t payload[FLASH_LOG_PAYLOAD], expected[FLASH_LOG_PAYLOAD];
+    uint32_t seq, prev = 0, count = 0, bad = 0;
+
+    emu_reset(0xFF);
+    flash_log_open(&log, &backend);
+    append_n(&log, SECTORS * RECORDS_PER_SECTOR);
+
+    flash_log_seek(&log, &it, 0);
+    while (flash_log_next(&log, &it, &seq, payload)) {
+        make_payload(seq, expected);
+        bad += seq <= prev || seq < flash_log_oldest(&log) || memcmp(payload, expected, sizeof(payload)) != 0;
+        // Ficou para trás: retoma no mais antigo ainda guardado, sem pular mais
+        bad += seq != prev + 1 && seq != flash_log_oldest(&log);
+        prev = seq;
+        count++;
+        // A cada registro lido chegam três: o setor do leitor é reciclado
+        append_n(&log, 3);
+        if (count > 10 * RECORDS_PER_SECTOR) {
+            break;
+        }
+    }
+    CHECK_EQ(bad, 0);
+    CHECK(count > RECORDS_PER_SECTOR);
+    CHECK(prev > SECTORS * RECORDS_PER_SECTOR);
+
+    // Leitor parado enquanto o setor dele é apagado e regravado com
+    // registros novos: retoma no mais antigo, não no meio dos novos
+    flash_log_seek(&log, &it, 0);
+    for (int i = 0; i < 20; i++) {
+        CHECK(flash_log_next(&log, &it, &seq, payload));
+    }
+    append_n(&log, (SECTORS - 1) * RECORDS_PER_SECTOR + 4 * RECORDS_PER_PAGE);
+    CHECK(flash_log_next(&log, &it, &seq, payload));
+    CHECK_EQ(seq, flash_log_oldest(&log));
+}
+
+int main(void) {
+    test_fresh();
+    test_append_batched();
+    test_rotation();
+    test_reopen();
+    test_torn_page();
+    test_iterator_recycle();
+    return check_result("flash_log");
+}
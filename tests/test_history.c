@@ -0,0 +1,127 @@
+// Camadas agregadas do histórico através de um reboot: os buckets de 1
+// minuto voltam do log da flash (history_restore) e a hora aberta continua
+// com amostras ao vivo (add_to_history). A média da hora tem de pesar cada
+// minuto igual, venha ele do log ou do vivo, e com qualquer número de
+// amostras no minuto. O resultado é lido por /api/history?res=1h.
+#include <stdio.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "lwip/tcp.h"
+#include "flash_log.h"
+#include "measurement.h"
+#include "check.h"
+
+// Mesmos valores e registro de Trabalho_SE_11.c
+#define HISTORY_METRICS 3
+#define HISTORY_LOG_SECTORS 64
+#define HISTORY_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - HISTORY_LOG_SECTORS * FLASH_SECTOR_SIZE)
+
+typedef struct {
+    uint32_t time_s;
+    uint16_t boot;
+    int16_t min[HISTORY_METRICS];
+    int16_t max[HISTORY_METRICS];
+    int16_t mean[HISTORY_METRICS];
+} HistoryLogEntry;
+
+#define SND_BUF 8192
+#define GET_1H "GET /api/history?res=1h HTTP/1.1\r\nHost: estacao\r\n\r\n"
+
+void start_http_server(void);
+void history_restore(void);
+void add_to_history(const measurement_t *m);
+
+// ---------- Boot anterior: log gravado direto na região da flash ----------
+
+static bool erase(void *ctx, uint32_t offset) {
+    (void)ctx;
+    flash_range_erase(HISTORY_LOG_OFFSET + offset, FLASH_SECTOR_SIZE);
+    return true;
+}
+
+static bool program(void *ctx, uint32_t offset, const uint8_t *page) {
+    (void)ctx;
+    flash_range_program(HISTORY_LOG_OFFSET + offset, page, FLASH_PAGE_SIZE);
+    return true;
+}
+
+static const flash_log_backend_t region = {
+    .base = host_flash + HISTORY_LOG_OFFSET,
+    .sector_count = HISTORY_LOG_SECTORS,
+    .erase = erase,
+    .program = program,
+};
+
+// Minutos [start_s, end_s) a temperature, como o boot anterior os teria fechado
+static void log_minutes(uint32_t start_s, uint32_t end_s, int16_t temperature) {
+    flash_log_t log;
+
+    CHECK(flash_log_open(&log, &region));
+    for (uint32_t t = start_s; t < end_s; t += 60) {
+        HistoryLogEntry e = {
+            .time_s = t,
+            .min = { temperature, 5000, 10133 },
+            .max = { temperature, 5000, 10133 },
+            .mean = { temperature, 5000, 10133 },
+        };
+        CHECK(flash_log_append(&log, &e));
+    }
+    CHECK(flash_log_flush(&log));
+}
+
+// ---------- Boot atual ----------
+
+static uint32_t clock_s;                 // Relógio do histórico, seguido pelo teste
+
+// Uma amostra a cada step_s segundos até o relógio chegar a end_s
+static void live(uint32_t end_s, uint32_t step_s, int32_t temperature) {
+    measurement_t m = { .temperature = temperature, .humidity = 5000, .pressure = 101325 };
+
+    while (clock_s < end_s) {
+        add_to_history(&m);
+        fake_time_advance_us(step_s * 1000000ull);
+        clock_s += step_s;
+    }
+}
+
+// Corpo de /api/history?res=1h
+static void get_hours(char *body, size_t cap) {
+    struct tcp_pcb *c = fake_tcp_connect(SND_BUF);
+
+    fake_tcp_send(c, GET_1H, strlen(GET_1H));
+    fake_tcp_ack_all(c);
+    const char *start = strstr(c->out, "\r\n\r\n");
+    CHECK(start != NULL);
+    snprintf(body, cap, "%s", start ? start + 4 : "");
+    fake_tcp_fin(c);
+    fake_tcp_free(c);
+}
+
+int main(void) {
+    char body[2048];
+
+    // Boot anterior parou na metade da hora que começa em 7200 s, a 20 °C
+    log_minutes(7200, 9000, 2000);
+
+    start_http_server();
+    history_restore();
+    clock_s = 9000;                      // Continua de onde o log parou
+
+    // Segunda metade da hora ao vivo a 30 °C, uma amostra por segundo
+    live(10800, 1, 3000);
+
+    // Hora seguinte só ao vivo: 30 min a 20 °C por segundo, 30 min a 30 °C
+    // com o laço atrasado (uma amostra a cada 2 s). A média é por minuto.
+    live(12600, 1, 2000);
+    live(14400, 2, 3000);
+
+    // O primeiro minuto da hora nova fecha a hora anterior
+    live(14460 + 1, 1, 2500);
+
+    get_hours(body, sizeof(body));
+    CHECK(strstr(body, "\"time\":[7200,10800]") != NULL);
+    CHECK(strstr(body, "\"temperature\":{\"mean\":[25.00,25.00],\"min\":[20.00,20.00],"
+                       "\"max\":[30.00,30.00]}") != NULL);
+    CHECK(strstr(body, "\"humidity\":{\"mean\":[50.00,50.00]") != NULL);
+    return check_result("history");
+}
@@ -0,0 +1,187 @@
+// Conexões persistentes do servidor HTTP sobre o lwIP falso: requisições em
+// pipeline num só pbuf, corpo de POST em vários segmentos, limite de
+// requisições por conexão, timeout de ociosidade pelo tcp_poll e pool cheio.
+#include <stdio.h>
+#include <string.h>
+#include "lwip/tcp.h"
+#include "check.h"
+
+// Mesmos valores de Trabalho_SE_11.c
+#define HTTP_MAX_CONNECTIONS 8
+#define HTTP_MAX_REQUESTS_PER_CONN 100
+#define HTTP_IDLE_TIMEOUT_S 5
+#define HTTP_POLL_INTERVAL 2
+#define IDLE_TICKS (HTTP_IDLE_TIMEOUT_S * 2 / HTTP_POLL_INTERVAL)
+
+#define SND_BUF 8192
+
+void start_http_server(void);
+
+#define GET_CONFIG "GET /api/config HTTP/1.1\r\nHost: estacao\r\n\r\n"
+
+static void send_str(struct tcp_pcb *pcb, const char *s) {
+    fake_tcp_send(pcb, s, strlen(s));
+}
+
+static void hang_up(struct tcp_pcb *pcb) {
+    fake_tcp_ack_all(pcb);
+    fake_tcp_fin(pcb);
+    CHECK(pcb->closed);
+    fake_tcp_free(pcb);
+}
+
+static void test_pipelined(void) {
+    struct tcp_pcb *c = fake_tcp_connect(SND_BUF);
+    const char *reqs = GET_CONFIG GET_CONFIG GET_CONFIG;
+
+    // Três requisições num só segmento: uma resposta por vez
+    send_str(c, reqs);
+    CHECK_EQ(fake_tcp_count(c, "HTTP/1.1 200 OK"), 1);
+    fake_tcp_ack(c, c->unacked);
+    CHECK_EQ(fake_tcp_count(c, "HTTP/1.1 200 OK"), 2);
+    fake_tcp_ack_all(c);
+    CHECK_EQ(fake_tcp_count(c, "HTTP/1.1 200 OK"), 3);
+    CHECK_EQ(fake_tcp_count(c, "Connection: keep-alive"), 3);
+
+    // Tudo lido e devolvido à janela, nada retido
+    CHECK_EQ(c->recved, strlen(reqs));
+    CHECK_EQ(fake_pbuf_live(), 0);
+    CHECK(!c->closed);
+
+    // A mesma conexão atende a próxima
+    send_str(c, GET_CONFIG);
+    fake_tcp_ack_all(c);
+    CHECK_EQ(fake_tcp_count(c, "HTTP/1.1 200 OK"), 4);
+    hang_up(c);
+}
+
+static void test_split_post(void) {
+    const char *post =
+        "POST /api/config HTTP/1.1\r\nHost: estacao\r\nContent-Length: 19\r\n\r\n"
+        "{\"temp_max\": 31.50}";
+
+    // POST picado em segmentos de 5 bytes, cada um num recv
+    struct tcp_pcb *c = fake_tcp_connect(SND_BUF);
+    fake_tcp_send_segments(c, post, strlen(post), 5);
+    CHECK_EQ(fake_tcp_count(c, "HTTP/1.1 200 OK"), 1);
+    fake_tcp_ack_all(c);
+
+    // E a próxima requisição em cadeia de pbufs num só recv
+    const char *get = GET_CONFIG;
+    fake_tcp_send_chain(c, get, strlen(get), 3);
+    fake_tcp_ack_all(c);
+    CHECK_EQ(fake_tcp_count(c, "HTTP/1.1 200 OK"), 2);
+    CHECK_EQ(fake_tcp_count(c, "\"temp_max\":31.50"), 1);
+    CHECK_EQ(c->recved, strlen(post) + strlen(get));
+    CHECK_EQ(fake_pbuf_live(), 0);
+    hang_up(c);
+
+    // Devolve o limite padrão para os outros casos
+    c = fake_tcp_connect(SND_BUF);
+    send_str(c, "POST /api/config HTTP/1.1\r\nContent-Length: 18\r\n\r\n{\"temp_max\":35.00}");
+    hang_up(c);
+}
+
+static void test_connection_close(void) {
+    struct tcp_pcb *c = fake_tcp_connect(SND_BUF);
+
+    send_str(c, "GET /api/config HTTP/1.1\r\nConnection: close\r\n\r\n");
+    CHECK_EQ(fake_tcp_count(c, "Connection: close"), 1);
+    CHECK(!c->closed);                   // Só fecha depois do ACK da resposta
+    fake_tcp_ack_all(c);
+    CHECK(c->closed);
+    fake_tcp_free(c);
+
+    // HTTP/1.0 sem keep-alive também fecha
+    c = fake_tcp_connect(SND_BUF);
+    send_str(c, "GET /api/config HTTP/1.0\r\n\r\n");
+    fake_tcp_ack_all(c);
+    CHECK(c->closed);
+    fake_tcp_free(c);
+
+    // FIN do cliente com resposta em andamento: termina de enviar e fecha
+    c = fake_tcp_connect(SND_BUF);
+    send_str(c, GET_CONFIG);
+    fake_tcp_fin(c);
+    CHECK(!c->closed);
+    fake_tcp_ack_all(c);
+    CHECK(c->closed);
+    fake_tcp_free(c);
+}
+
+static void test_request_cap(void) {
+    struct tcp_pcb *c = fake_tcp_connect(SND_BUF);
+
+    for (int i = 0; i < HTTP_MAX_REQUESTS_PER_CONN && !c->closed; i++) {
+        send_str(c, GET_CONFIG);
+        fake_tcp_ack_all(c);
+    }
+    CHECK_EQ(fake_tcp_count(c, "HTTP/1.1 200 OK"), HTTP_MAX_REQUESTS_PER_CONN);
+    CHECK_EQ(fake_tcp_count(c, "Connection: close"), 1);
+    CHECK(c->closed);
+    fake_tcp_free(c);
+}
+
+static void test_idle_timeout(void) {
+    struct tcp_pcb *c = fake_tcp_connect(SND_BUF);
+
+    for (int i = 0; i < IDLE_TICKS - 1; i++) {
+        fake_tcp_tick(c);
+    }
+    CHECK(!c->closed);
+
+    // Uma requisição zera a contagem
+    send_str(c, GET_CONFIG);
+    fake_tcp_ack_all(c);
+    for (int i = 0; i < IDLE_TICKS - 1; i++) {
+        fake_tcp_tick(c);
+    }
+    CHECK(!c->closed);
+    fake_tcp_tick(c);
+    CHECK(c->closed);
+    fake_tcp_free(c);
+
+    // Meia requisição parada também expira, sem vazar o pbuf retido
+    c = fake_tcp_connect(SND_BUF);
+    send_str(c, "GET /api/con");
+    for (int i = 0; i < IDLE_TICKS; i++) {
+        fake_tcp_tick(c);
+    }
+    CHECK(c->closed);
+    CHECK_EQ(fake_pbuf_live(), 0);
+    fake_tcp_free(c);
+}
+
+static void test_pool_full(void) {
+    struct tcp_pcb *conns[HTTP_MAX_CONNECTIONS];
+
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        conns[i] = fake_tcp_connect(SND_BUF);
+        CHECK(!conns[i]->closed);
+    }
+
+    // Acima do pool: 503 imediato e fecha
+    struct tcp_pcb *extra = fake_tcp_connect(SND_BUF);
+    CHECK_EQ(fake_tcp_count(extra, "503"), 1);
+    CHECK(extra->closed);
+    fake_tcp_free(extra);
+
+    // Um slot liberado volta a aceitar
+    hang_up(conns[0]);
+    conns[0] = fake_tcp_connect(SND_BUF);
+    CHECK(!conns[0]->closed);
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        hang_up(conns[i]);
+    }
+}
+
+int main(void) {
+    start_http_server();
+    test_pipelined();
+    test_split_post();
+    test_connection_close();
+    test_request_cap();
+    test_idle_timeout();
+    test_pool_full();
+    return check_result("http keep-alive");
+}
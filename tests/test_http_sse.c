@@ -0,0 +1,215 @@
+// Fluxo /api/stream sobre o lwIP falso: as amostras entram pelo mesmo
+// caminho do firmware (sample_publish no núcleo 1, core0_receive_samples no
+// núcleo 0). Cliente lento perde amostras intermediárias em vez de acumular
+// eventos, sem atrasar os outros, e sempre termina com a mais recente.
+#include <stdio.h>
+#include <string.h>
+#include "lwip/tcp.h"
+#include "measurement.h"
+#include "check.h"
+
+// Mesmos valores de Trabalho_SE_11.c
+#define HTTP_MAX_SSE_CLIENTS 4
+#define HTTP_SSE_MAX_INFLIGHT 512
+#define HTTP_IDLE_TIMEOUT_S 5
+#define HTTP_POLL_INTERVAL 2
+#define IDLE_TICKS (HTTP_IDLE_TIMEOUT_S * 2 / HTTP_POLL_INTERVAL)
+
+#define SND_BUF 8192
+#define GET_STREAM "GET /api/stream HTTP/1.1\r\nHost: estacao\r\nAccept: text/event-stream\r\n\r\n"
+
+void start_http_server(void);
+bool sample_publish(measurement_t *m);
+void core0_receive_samples(void);
+bool http_idle(void);
+
+static int32_t next_temperature = 2000;
+
+// Uma amostra nova do núcleo 1 até o fluxo; retorna a temperatura publicada
+static int32_t publish(void) {
+    measurement_t m = {
+        .temperature = next_temperature, .humidity = 5000, .pressure = 101325
+    };
+    next_temperature += 1;
+    sample_publish(&m);
+    core0_receive_samples();
+    return m.temperature;
+}
+
+static struct tcp_pcb *open_stream(void) {
+    struct tcp_pcb *c = fake_tcp_connect(SND_BUF);
+    fake_tcp_send(c, GET_STREAM, strlen(GET_STREAM));
+    return c;
+}
+
+static void close_stream(struct tcp_pcb *c) {
+    fake_tcp_fin(c);
+    CHECK(c->closed);
+    fake_tcp_free(c);
+}
+
+// Temperatura do último evento escrito no PCB, em centésimos
+static int32_t last_temperature(const struct tcp_pcb *c) {
+    const char *last = NULL;
+    for (const char *p = c->out; (p = strstr(p, "data: ")); p++) {
+        last = p;
+    }
+    const char *t = last ? strstr(last, "\"temperature\":") : NULL;
+    int whole = 0, frac = 0;
+    if (!t || sscanf(t, "\"temperature\":%d.%d", &whole, &frac) != 2) {
+        return -1;
+    }
+    return whole * 100 + frac;
+}
+
+static char *temperature_text(char *buf, int32_t t) {
+    sprintf(buf, "\"temperature\":%d.%02d,", (int)(t / 100), (int)(t % 100));
+    return buf;
+}
+
+static void test_stream_header(void) {
+    struct tcp_pcb *c = open_stream();
+
+    CHECK_EQ(fake_tcp_count(c, "Content-Type: text/event-stream"), 1);
+    fake_tcp_ack_all(c);
+    CHECK(!c->closed);
+
+    // Quem conecta recebe logo a última amostra, sem esperar a próxima
+    CHECK_EQ(fake_tcp_count(c, "data: {"), 1);
+    CHECK_EQ(last_temperature(c), next_temperature - 1);
+
+    // Eventos inteiros, um por amostra: "data: {...}\n\n"
+    int32_t t = publish();
+    CHECK_EQ(fake_tcp_count(c, "data: {"), 2);
+    CHECK_EQ(last_temperature(c), t);
+    CHECK(c->out_len > 2 && memcmp(c->out + c->out_len - 2, "\n\n", 2) == 0);
+    close_stream(c);
+}
+
+static void test_slow_client(void) {
+    struct tcp_pcb *fast = open_stream();
+    struct tcp_pcb *slow = open_stream();
+    char text[32];
+    int32_t first = 0, last = 0;
+
+    fake_tcp_ack_all(fast);
+    fake_tcp_ack_all(slow);
+    size_t header = slow->out_len;       // Cabeçalho e a amostra da conexão
+
+    // O lento nunca confirma: o que fica em voo não passa do limite
+    for (int i = 0; i < 40; i++) {
+        last = publish();
+        if (i == 0) {
+            first = last;
+        }
+        fake_tcp_ack_all(fast);
+        CHECK(slow->unacked <= HTTP_SSE_MAX_INFLIGHT);
+    }
+
+    // O rápido recebeu todas
+    CHECK_EQ(fake_tcp_count(fast, "data: {"), 1 + 40);
+    CHECK_EQ(last_temperature(fast), last);
+
+    // O lento recebeu só as que couberam, sem eventos cortados
+    size_t early = fake_tcp_count(slow, "data: {");
+    CHECK(early >= 2 && early < 1 + 40);
+    CHECK_EQ(fake_tcp_count(slow, "\n\n"), early + 1);   // + "retry: 3000\n\n"
+    CHECK(slow->out_len - header <= HTTP_SSE_MAX_INFLIGHT);
+    CHECK_EQ(fake_tcp_count(slow, temperature_text(text, first)), 1);
+
+    // Ao confirmar, recebe a mais recente e pula as intermediárias
+    fake_tcp_ack_all(slow);
+    CHECK_EQ(fake_tcp_count(slow, "data: {"), early + 1);
+    CHECK_EQ(last_temperature(slow), last);
+    CHECK_EQ(fake_tcp_count(slow, temperature_text(text, last - 1)), 0);
+
+    // E volta ao ritmo normal
+    last = publish();
+    fake_tcp_ack_all(slow);
+    CHECK_EQ(last_temperature(slow), last);
+
+    close_stream(fast);
+    close_stream(slow);
+}
+
+static void test_client_limit(void) {
+    struct tcp_pcb *streams[HTTP_MAX_SSE_CLIENTS];
+
+    for (int i = 0; i < HTTP_MAX_SSE_CLIENTS; i++) {
+        streams[i] = open_stream();
+        CHECK_EQ(fake_tcp_count(streams[i], "text/event-stream"), 1);
+    }
+    struct tcp_pcb *extra = open_stream();
+    CHECK_EQ(fake_tcp_count(extra, "503"), 1);
+    fake_tcp_ack_all(extra);
+    CHECK(extra->closed);
+    fake_tcp_free(extra);
+
+    // Fechar um fluxo libera a vaga
+    close_stream(streams[0]);
+    streams[0] = open_stream();
+    CHECK_EQ(fake_tcp_count(streams[0], "text/event-stream"), 1);
+    for (int i = 0; i < HTTP_MAX_SSE_CLIENTS; i++) {
+        close_stream(streams[i]);
+    }
+}
+
+static void test_idle(void) {
+    struct tcp_pcb *c = open_stream();
+
+    // Fluxo sem nada em voo não expira
+    fake_tcp_ack_all(c);
+    for (int i = 0; i < IDLE_TICKS * 3; i++) {
+        fake_tcp_tick(c);
+    }
+    CHECK(!c->closed);
+
+    // Cliente que parou de confirmar eventos expira
+    publish();
+    for (int i = 0; i < IDLE_TICKS; i++) {
+        fake_tcp_tick(c);
+    }
+    CHECK(c->closed);
+    fake_tcp_free(c);
+
+    // A vaga do fluxo expirado volta ao pool
+    c = open_stream();
+    CHECK_EQ(fake_tcp_count(c, "text/event-stream"), 1);
+    close_stream(c);
+    CHECK_EQ(fake_pbuf_live(), 0);
+}
+
+// O flash_task só apaga setores com http_idle(): fluxo aberto e em dia não
+// segura a flash, evento sem ACK segura
+static void test_flash_idle(void) {
+    struct tcp_pcb *c = open_stream();
+
+    fake_tcp_ack_all(c);
+    CHECK(http_idle());
+    publish();
+    CHECK(!http_idle());
+    fake_tcp_ack_all(c);
+    CHECK(http_idle());
+
+    // Uma resposta comum em envio também segura
+    struct tcp_pcb *get = fake_tcp_connect(SND_BUF);
+    const char *req = "GET / HTTP/1.1\r\n\r\n";
+    fake_tcp_send(get, req, strlen(req));
+    CHECK(!http_idle());
+    fake_tcp_ack_all(get);
+    CHECK(http_idle());
+    fake_tcp_fin(get);
+    fake_tcp_free(get);
+    close_stream(c);
+}
+
+int main(void) {
+    start_http_server();
+    publish();                           // Sem clientes, só alimenta o histórico
+    test_stream_header();
+    test_slow_client();
+    test_client_limit();
+    test_idle();
+    test_flash_idle();
+    return check_result("http sse");
+}
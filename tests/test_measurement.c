@@ -0,0 +1,181 @@
+// Ponto fixo x o caminho em float que ele substituiu: conversão do AHT20
+// em toda a faixa de 20 bits, fixed_format contra printf("%.*f") e
+// fixed_parse contra strtod. O float antigo guardava a leitura como float e
+// formatava com printf; o ponto fixo tem de dar o mesmo valor e o mesmo
+// texto, exceto nos empates e no "-0.0" que o printf escrevia.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "aht20.h"
+#include "measurement.h"
+#include "check.h"
+
+// ---------- AHT20 no barramento falso: devolve sempre raw nos dois canais ----------
+
+static uint32_t raw;
+
+static uint8_t crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c, (void)addr, (void)src, (void)nostop;
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)i2c, (void)addr, (void)nostop;
+    uint8_t frame[7] = {
+        0x08, (uint8_t)(raw >> 12), (uint8_t)(raw >> 4), (uint8_t)((raw << 4) | (raw >> 16)),
+        (uint8_t)(raw >> 8), (uint8_t)raw, 0
+    };
+    frame[6] = crc8(frame, 6);
+    memcpy(dst, frame, len < sizeof(frame) ? len : sizeof(frame));
+    return (int)len;
+}
+
+// ---------- Referências ----------
+
+// O float escrevia "-0.0" para -0,04; o ponto fixo escreve "0.0"
+static void drop_negative_zero(char *buf) {
+    if (buf[0] == '-' && strspn(buf + 1, "0.") == strlen(buf + 1)) {
+        memmove(buf, buf + 1, strlen(buf));
+    }
+}
+
+// printf do valor em double, como o firmware antigo. Nos empates decimais
+// o double cai de um lado ou do outro do meio; o ponto fixo sempre afasta
+// do zero, então a referência é o valor empurrado um pouco para fora.
+static void printf_reference(char *buf, size_t cap, int32_t value, int decimals, int shown) {
+    double scale = pow(10, decimals);
+    double x = value / scale;
+    int32_t step = (int32_t)pow(10, decimals - shown);
+    if (step > 1 && abs(value) % step == step / 2) {
+        x += (value < 0 ? -0.1 : 0.1) / scale;
+    }
+    snprintf(buf, cap, "%.*f", shown, x);
+    drop_negative_zero(buf);
+}
+
+static void test_aht20_conversion(void) {
+    AHT20_Data data;
+    int failed = 0, exact = 0, old_off = 0, old_text = 0, rounded_twice = 0;
+    char a[16], b[16];
+
+    for (raw = 0; raw < (1u << 20); raw++) {
+        aht20_trigger(NULL);
+        sleep_ms(AHT20_MEASURE_TIME_MS);
+        if (!aht20_collect(NULL, &data)) {
+            failed++;
+            continue;
+        }
+
+        // Valor exato do datasheet, arredondado ao centésimo
+        exact += data.humidity != llround(raw * 10000.0 / 1048576.0);
+        exact += data.temperature != llround(raw * 20000.0 / 1048576.0) - 5000;
+
+        // Caminho antigo: float em °C e %UR, exibido com "%.1f"
+        float humidity = (float)raw * 100.0 / 1048576.0;
+        float temperature = ((float)raw * 200.0 / 1048576.0) - 50.0;
+        old_off += labs(data.humidity - lroundf(humidity * 100)) > 1;
+        old_off += labs(data.temperature - lroundf(temperature * 100)) > 1;
+
+        // Texto em "%.1f": o centésimo guardado já foi arredondado, então
+        // quando ele termina em 5 o décimo pode subir uma unidade (ex.:
+        // 25,046 -> 25,05 -> 25,1, onde o float dava 25,0). Fora isso, igual.
+        fixed_format(a, sizeof(a), data.temperature, MEASUREMENT_DECIMALS, 1);
+        snprintf(b, sizeof(b), "%.1f", temperature);
+        drop_negative_zero(b);
+        if (strcmp(a, b) != 0) {
+            if (labs(data.temperature) % 10 == 5) {
+                rounded_twice++;
+            } else {
+                old_text++;
+            }
+        }
+    }
+    CHECK_EQ(failed, 0);
+    CHECK_EQ(exact, 0);
+    CHECK_EQ(old_off, 0);
+    CHECK_EQ(old_text, 0);
+    printf("AHT20: %d de %d temperaturas com o décimo exibido diferente do float (centésimo em 5)\n",
+           rounded_twice, 1 << 20);
+}
+
+static void test_format(void) {
+    char a[24], b[24];
+    int mismatches = 0;
+
+    for (int32_t v = -200000; v <= 200000; v++) {
+        for (int shown = 0; shown <= MEASUREMENT_DECIMALS; shown++) {
+            fixed_format(a, sizeof(a), v, MEASUREMENT_DECIMALS, (uint8_t)shown);
+            printf_reference(b, sizeof(b), v, MEASUREMENT_DECIMALS, shown);
+            mismatches += strcmp(a, b) != 0;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    // Extremos (o arredondamento não pode estourar) e buffer curto
+    fixed_format(a, sizeof(a), INT32_MIN, 2, 2);
+    CHECK(strcmp(a, "-21474836.48") == 0);
+    fixed_format(a, sizeof(a), INT32_MAX, 2, 0);
+    CHECK(strcmp(a, "21474836") == 0);
+    CHECK_EQ(fixed_format(a, 4, 123456, 2, 2), 3);
+    CHECK(strcmp(a, "123") == 0);
+}
+
+static void test_parse(void) {
+    char text[32];
+    int32_t out;
+    int off = 0, ends = 0;
+    uint32_t seed = 99;
+
+    // Números como os do formulário e do JSON, com 0 a 5 casas
+    for (int i = 0; i < 400000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        double x = ((int32_t)(seed >> 1) % 4000000) / 37.0;
+        snprintf(text, sizeof(text), "%.*f", i % 6, i & 1 ? -x : x);
+
+        char *end;
+        double d = strtod(text, &end);
+        const char *fend = fixed_parse(text, MEASUREMENT_DECIMALS, &out);
+        ends += fend != end;
+        // Arredondado ao centésimo mais próximo
+        off += fend && fabs(out - d * 100) > 0.5 + 1e-6;
+    }
+    CHECK_EQ(ends, 0);
+    CHECK_EQ(off, 0);
+
+    // Empate decidido pela primeira casa extra, longe do zero
+    CHECK(fixed_parse("1.005", 2, &out) && out == 101);
+    CHECK(fixed_parse("-1.005", 2, &out) && out == -101);
+    CHECK(fixed_parse("1.00499", 2, &out) && out == 100);
+    CHECK(fixed_parse(".5", 2, &out) && out == 50);
+
+    // Para onde o strtod pararia, sem expoente; sem dígitos ou grande demais: NULL
+    CHECK(strcmp(fixed_parse("31.50,\"x\"", 2, &out), ",\"x\"") == 0 && out == 3150);
+    CHECK(strcmp(fixed_parse("2e1", 2, &out), "e1") == 0 && out == 200);
+    CHECK(fixed_parse("", 2, &out) == NULL);
+    CHECK(fixed_parse("-", 2, &out) == NULL);
+    CHECK(fixed_parse(".", 2, &out) == NULL);
+    CHECK(fixed_parse("abc", 2, &out) == NULL);
+    CHECK(fixed_parse("21474837", 2, &out) == NULL);
+    CHECK(fixed_parse("21474836.47", 2, &out) && out == INT32_MAX);
+}
+
+int main(void) {
+    test_aht20_conversion();
+    test_format();
+    test_parse();
+    return check_result("measurement");
+}
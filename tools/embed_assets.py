@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""Comprime os arquivos do painel web e gera um header C com os bytes.
+
+Cada asset é comprimido com gzip (mtime fixo, para o build ser reproduzível)
+e recebe um ETag forte derivado do SHA-256 do conteúdo. Os cabeçalhos HTTP
+das respostas 200 e 304 também são gerados aqui, com Content-Length e ETag
+já resolvidos, para o firmware enviá-los direto da flash.
+
+Os cabeçalhos terminam sem a linha em branco final: o servidor acrescenta
+"Connection: keep-alive" ou "Connection: close" conforme a conexão.
+
+Uso: embed_assets.py <saida.h> <rota>=<arquivo> [<rota>=<arquivo> ...]
+"""
+import gzip
+import hashlib
+import os
+import sys
+
+CONTENT_TYPES = {
+    '.html': 'text/html; charset=utf-8',
+    '.js': 'application/javascript; charset=utf-8',
+    '.css': 'text/css; charset=utf-8',
+}
+
+CACHE_CONTROL = 'no-cache'  # sempre revalida; com ETag a resposta vira 304
+
+
+def c_string(text):
+    return '"' + text.replace('\\', '\\\\').replace('"', '\\"').replace('\r', '\\r').replace('\n', '\\n') + '"'
+
+
+def c_bytes(data, indent='    ', per_line=16):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ', '.join('0x%02X' % b for b in data[i:i + per_line]) + ',')
+    return '\n'.join(lines)
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    out_path = sys.argv[1]
+    assets = []
+    for arg in sys.argv[2:]:
+        route, path = arg.split('=', 1)
+        with open(path, 'rb') as f:
+            raw = f.read()
+        body = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = '"%s"' % hashlib.sha256(raw).hexdigest()[:16]
+        ctype = CONTENT_TYPES[os.path.splitext(path)[1]]
+        header_200 = ('HTTP/1.1 200 OK\r\n'
+                      'Content-Type: %s\r\n'
+                      'Content-Encoding: gzip\r\n'
+                      'Content-Length: %d\r\n'
+                      'ETag: %s\r\n'
+                      'Cache-Control: %s\r\n') % (ctype, len(body), etag, CACHE_CONTROL)
+        header_304 = ('HTTP/1.1 304 Not Modified\r\n'
+                      'ETag: %s\r\n'
+                      'Cache-Control: %s\r\n') % (etag, CACHE_CONTROL)
+        assets.append((route, os.path.basename(path), raw, body, etag, header_200, header_304))
+
+    out = [
+        '// Gerado por tools/embed_assets.py a partir de web/. Não editar.',
+        '#ifndef WEB_ASSETS_H',
+        '#define WEB_ASSETS_H',
+        '',
+        '#include <stddef.h>',
+        '#include <stdint.h>',
+        '',
+        'typedef struct {',
+        '    const char *path;',
+        '    const uint8_t *body;       // conteúdo comprimido com gzip',
+        '    size_t body_len;',
+        '    const char *etag;',
+        '    const char *header_200;',
+        '    size_t header_200_len;',
+        '    const char *header_304;',
+        '    size_t header_304_len;',
+        '} web_asset_t;',
+        '',
+    ]
+    for i, (route, name, raw, body, etag, h200, h304) in enumerate(assets):
+        out.append('// %s: %d bytes -> %d bytes com gzip' % (name, len(raw), len(body)))
+        out.append('static const uint8_t web_asset_%d_body[] = {' % i)
+        out.append(c_bytes(body))
+        out.append('};')
+        out.append('')
+    out.append('static const web_asset_t web_assets[] = {')
+    for i, (route, name, raw, body, etag, h200, h304) in enumerate(assets):
+        out.append('    {')
+        out.append('        .path = %s,' % c_string(route))
+        out.append('        .body = web_asset_%d_body,' % i)
+        out.append('        .body_len = %d,' % len(body))
+        out.append('        .etag = %s,' % c_string(etag))
+        out.append('        .header_200 = %s,' % c_string(h200))
+        out.append('        .header_200_len = %d,' % len(h200))
+        out.append('        .header_304 = %s,' % c_string(h304))
+        out.append('        .header_304_len = %d,' % len(h304))
+        out.append('    },')
+    out += ['};', '', '#define WEB_ASSET_COUNT %d' % len(assets), '', '#endif // WEB_ASSETS_H', '']
+
+    with open(out_path, 'w', encoding='utf-8') as f:
+        f.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+"""Gera as tabelas de log2/exp2 usadas por lib/derived.c.
+
+Cada tabela tem 257 pontos em Q30 sobre [1, 2): log2(1 + i/256) e
+2^(i/256). O código interpola linearmente entre pontos vizinhos; com esse
+passo o erro é < 3e-6 em log2 e < 2e-6 (relativo) em exp2.
+
+Uso: gen_derived_tables.py <saida.h>
+"""
+import math
+import sys
+
+STEPS = 256
+ONE = 1 << 30
+
+
+def table(name, values):
+    lines = [f'static const uint32_t {name}[{len(values)}] = {{']
+    for i in range(0, len(values), 6):
+        row = ', '.join(f'0x{v:08X}' for v in values[i:i + 6])
+        lines.append(f'    {row},')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit('uso: gen_derived_tables.py <saida.h>')
+
+    log2 = [round(math.log2(1 + i / STEPS) * ONE) for i in range(STEPS + 1)]
+    exp2 = [round(2 ** (i / STEPS) * ONE) for i in range(STEPS + 1)]
+
+    with open(sys.argv[1], 'w', encoding='utf-8') as f:
+        f.write('// Gerado por tools/gen_derived_tables.py - não editar\n')
+        f.write('#ifndef DERIVED_TABLES_H\n#define DERIVED_TABLES_H\n\n')
+        f.write('#include <stdint.h>\n\n')
+        f.write(f'#define DERIVED_TABLE_BITS {STEPS.bit_length() - 1}\n\n')
+        f.write(table('log2_table', log2) + '\n\n')
+        f.write(table('exp2_table', exp2) + '\n\n')
+        f.write('#endif\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Gera a fonte grande (16x24) a partir da fonte 8x8 de lib/font.h.
+
+Cada glifo 8x8 é ampliado 2x na horizontal e 3x na vertical e gravado no
+layout nativo do SSD1306 usado pelo ram_buffer: coluna a coluna, com as
+páginas (8 linhas por byte, bit 0 em cima) de cada coluna em sequência.
+Assim o blitter copia bytes direto para o framebuffer.
+
+Uso: gen_font.py <font.h> <saida.h>
+"""
+import re
+import sys
+
+FIRST, LAST = ' ', '9'   # sinais, ponto e dígitos
+SCALE_X, SCALE_Y = 2, 3
+SRC_W = SRC_H = 8
+DST_W, DST_H = SRC_W * SCALE_X, SRC_H * SCALE_Y
+PAGES = DST_H // 8
+
+
+def load_font(path):
+    with open(path, encoding='utf-8') as f:
+        data = [int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{2})', f.read())]
+    return [data[i:i + SRC_W] for i in range(0, len(data), SRC_W)]
+
+
+def scale_glyph(cols):
+    out = []
+    for col in cols:
+        # Coluna ampliada como inteiro de DST_H bits (bit 0 = linha do topo)
+        bits = 0
+        for row in range(SRC_H):
+            if col & (1 << row):
+                for k in range(SCALE_Y):
+                    bits |= 1 << (row * SCALE_Y + k)
+        pages = [(bits >> (8 * p)) & 0xFF for p in range(PAGES)]
+        for _ in range(SCALE_X):
+            out.extend(pages)
+    return out
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    glyphs = load_font(sys.argv[1])
+    lines = [
+        '// Gerado por tools/gen_font.py a partir de lib/font.h. Não editar.',
+        '#ifndef FONT_LARGE_H',
+        '#define FONT_LARGE_H',
+        '',
+        '#define FONT_LARGE_WIDTH  %d' % DST_W,
+        '#define FONT_LARGE_HEIGHT %d' % DST_H,
+        "#define FONT_LARGE_FIRST  '%s'" % FIRST,
+        "#define FONT_LARGE_LAST   '%s'" % LAST,
+        '',
+        'static const uint8_t font_large[] = {',
+    ]
+    for code in range(ord(FIRST), ord(LAST) + 1):
+        data = scale_glyph(glyphs[code - 0x20])
+        lines.append('    ' + ', '.join('0x%02X' % b for b in data) + ',  // %s' % chr(code))
+    lines += ['};', '', '#endif // FONT_LARGE_H', '']
+    with open(sys.argv[2], 'w', encoding='utf-8') as f:
+        f.write('\n'.join(lines))
+
+
+if __name__ == '__main__':
+    main()
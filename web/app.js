@@ -0,0 +1,273 @@
+const MAX_POINTS = 50;
+
+let tempChart, humidChart, pressChart;
+let tempData = [], humidData = [], pressData = [];
+let tempMin = [], humidMin = [], pressMin = [];
+let tempMax = [], humidMax = [], pressMax = [];
+let labels = [];
+let pollTimer = null;
+let lastSeq = 0;  // Última amostra já nos gráficos
+let range = 'live';  // 'live' (amostras de 1 s) ou a resolução de /api/history
+let historyTimer = null;
+
+// Linhas tracejadas de mínimo e máximo (vazias no modo ao vivo)
+function bandDatasets(min, max, color) {
+  const style = { borderColor: color, borderDash: [4, 4], borderWidth: 1, pointRadius: 0 };
+  return [
+    Object.assign({ label: 'Mín', data: min }, style),
+    Object.assign({ label: 'Máx', data: max }, style)
+  ];
+}
+
+function initCharts() {
+  const chartOptions = {
+    responsive: true,
+    maintainAspectRatio: false,
+    scales: {
+      x: { display: false },
+      y: { beginAtZero: false }
+    },
+    animation: { duration: 0 }
+  };
+
+  tempChart = new Chart(document.getElementById('tempChart'), {
+    type: 'line',
+    data: {
+      labels: labels,
+      datasets: [{
+        label: 'Temperatura (°C)',
+        data: tempData,
+        borderColor: '#ff6b6b',
+        tension: 0.1
+      }].concat(bandDatasets(tempMin, tempMax, '#ff6b6b'))
+    },
+    options: chartOptions
+  });
+
+  humidChart = new Chart(document.getElementById('humidChart'), {
+    type: 'line',
+    data: {
+      labels: labels,
+      datasets: [{
+        label: 'Umidade (%)',
+        data: humidData,
+        borderColor: '#4ecdc4',
+        tension: 0.1
+      }].concat(bandDatasets(humidMin, humidMax, '#4ecdc4'))
+    },
+    options: chartOptions
+  });
+
+  pressChart = new Chart(document.getElementById('pressChart'), {
+    type: 'line',
+    data: {
+      labels: labels,
+      datasets: [{
+        label: 'Pressão (hPa)',
+        data: pressData,
+        borderColor: '#45b7d1',
+        tension: 0.1
+      }].concat(bandDatasets(pressMin, pressMax, '#45b7d1'))
+    },
+    options: chartOptions
+  });
+}
+
+function showCurrent(data) {
+  document.getElementById('temp').textContent = data.temperature.toFixed(1);
+  document.getElementById('humid').textContent = data.humidity.toFixed(1);
+  document.getElementById('press').textContent = data.pressure.toFixed(1);
+  document.getElementById('alt').textContent = data.altitude.toFixed(1);
+  document.getElementById('dew').textContent = data.dew_point.toFixed(1);
+  document.getElementById('abs_humid').textContent = data.abs_humidity.toFixed(1);
+  document.getElementById('heat').textContent = data.heat_index.toFixed(1);
+
+  if (data.alert) {
+    document.getElementById('alert').textContent = data.alert;
+    document.getElementById('alert').classList.add('active');
+  } else {
+    document.getElementById('alert').classList.remove('active');
+  }
+}
+
+// Horário local de uma amostra a partir do relógio da placa (segundos)
+function sampleDate(time, uptime) {
+  return new Date(Date.now() - (uptime - time) * 1000);
+}
+
+function sampleLabel(time, uptime) {
+  return sampleDate(time, uptime).toLocaleTimeString();
+}
+
+function clearSeries() {
+  [labels, tempData, humidData, pressData, tempMin, humidMin, pressMin, tempMax, humidMax, pressMax]
+    .forEach(a => { a.length = 0; });
+}
+
+function pushPoint(label, temp, humid, press) {
+  labels.push(label);
+  tempData.push(temp);
+  humidData.push(humid);
+  pressData.push(press);
+  if (labels.length > MAX_POINTS) {
+    labels.shift();
+    tempData.shift();
+    humidData.shift();
+    pressData.shift();
+  }
+}
+
+function refreshCharts() {
+  [tempChart, humidChart, pressChart].forEach(c => c.update());
+}
+
+// Pede só as amostras depois de lastSeq; "reset" indica que a placa mandou o histórico inteiro
+function updateData() {
+  fetch('/api/data' + (lastSeq ? '?since=' + lastSeq : '')).then(r => r.json()).then(data => {
+    showCurrent(data);
+    if (range !== 'live') {
+      return;
+    }
+
+    const h = data.history;
+    const first = data.seq - h.time.length + 1;
+    if (data.reset) {
+      clearSeries();
+      lastSeq = 0;
+    }
+    for (let i = 0; i < h.time.length; i++) {
+      if (first + i <= lastSeq) {
+        continue;  // Já chegou pelo fluxo SSE enquanto a requisição estava em andamento
+      }
+      pushPoint(sampleLabel(h.time[i], data.uptime), h.temperature[i], h.humidity[i], h.pressure[i]);
+    }
+    lastSeq = Math.max(lastSeq, data.seq);
+    refreshCharts();
+  });
+}
+
+// Acrescenta uma amostra do fluxo SSE aos gráficos; se faltou alguma, busca o trecho
+function appendSample(data) {
+  if (range !== 'live') {
+    return;
+  }
+  if (data.seq === lastSeq + 1) {
+    lastSeq = data.seq;
+    pushPoint(new Date().toLocaleTimeString(), data.temperature, data.humidity, data.pressure);
+    refreshCharts();
+  } else if (data.seq !== lastSeq) {
+    if (data.seq < lastSeq) {
+      lastSeq = 0;  // Placa reiniciou
+    }
+    updateData();
+  }
+}
+
+// Histórico da resolução escolhida: agregado (mín/máx/média) ou bruto comprimido na placa
+function loadHistory() {
+  const res = range;
+  fetch('/api/history?res=' + res).then(r => r.json()).then(data => {
+    if (range !== res) {
+      return;  // O usuário trocou o período enquanto a resposta chegava
+    }
+    clearSeries();
+    if (data.samples) {
+      // Amostras brutas [time, temperatura, umidade, pressão], sem mín/máx
+      data.samples.forEach(s => {
+        labels.push(sampleLabel(s[0], data.uptime));
+        tempData.push(s[1]);
+        humidData.push(s[2]);
+        pressData.push(s[3]);
+      });
+      refreshCharts();
+      return;
+    }
+    const format = res === '1h'
+      ? { weekday: 'short', hour: '2-digit', minute: '2-digit' }
+      : { hour: '2-digit', minute: '2-digit' };
+    data.time.forEach((t, i) => {
+      labels.push(sampleDate(t, data.uptime).toLocaleString([], format));
+      tempData.push(data.temperature.mean[i]);
+      tempMin.push(data.temperature.min[i]);
+      tempMax.push(data.temperature.max[i]);
+      humidData.push(data.humidity.mean[i]);
+      humidMin.push(data.humidity.min[i]);
+      humidMax.push(data.humidity.max[i]);
+      pressData.push(data.pressure.mean[i]);
+      pressMin.push(data.pressure.min[i]);
+      pressMax.push(data.pressure.max[i]);
+    });
+    refreshCharts();
+  });
+}
+
+function setRange(value) {
+  range = value;
+  clearInterval(historyTimer);
+  historyTimer = null;
+  clearSeries();
+  refreshCharts();
+  if (range === 'live') {
+    lastSeq = 0;
+    updateData();
+  } else {
+    loadHistory();
+    historyTimer = setInterval(loadHistory, 60000);  // Um bucket novo por minuto, no máximo
+  }
+}
+
+function startPolling() {
+  if (!pollTimer) {
+    pollTimer = setInterval(updateData, 1000);
+  }
+}
+
+// Recebe uma amostra por evento; sem suporte ou com o fluxo recusado, volta ao polling
+function startStream() {
+  if (!window.EventSource) {
+    startPolling();
+    return;
+  }
+  const es = new EventSource('/api/stream');
+  es.onmessage = e => {
+    const data = JSON.parse(e.data);
+    showCurrent(data);
+    appendSample(data);
+  };
+  es.onerror = () => {
+    if (es.readyState === EventSource.CLOSED) {
+      startPolling();
+    }
+  };
+}
+
+function loadConfig() {
+  fetch('/api/config').then(r => r.json()).then(data => {
+    Object.keys(data).forEach(key => {
+      const el = document.getElementById(key);
+      if (el) el.value = data[key];
+    });
+  });
+}
+
+function saveConfig() {
+  const config = {};
+  ['temp_min', 'temp_max', 'humid_min', 'humid_max', 'press_min', 'press_max',
+   'temp_offset', 'humid_offset', 'press_offset', 'temp_gain', 'humid_gain', 'press_gain',
+   'qnh', 'heat_max'].forEach(id => {
+    config[id] = parseFloat(document.getElementById(id).value);
+  });
+
+  fetch('/api/config', {
+    method: 'POST',
+    headers: { 'Content-Type': 'application/json' },
+    body: JSON.stringify(config)
+  }).then(() => alert('Configurações salvas!'));
+}
+
+window.onload = () => {
+  initCharts();
+  loadConfig();
+  updateData();
+  startStream();
+};